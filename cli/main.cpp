@@ -0,0 +1,3 @@
+#include <cstring>
+#include "my_helpy.h"
+int main(int argc, char **argv){ MyHelpy h; if (argc > 1 && !strcmp(argv[1], "-i")) { h.run(); return 0; } return h.run(argc, argv); }
@@ -0,0 +1,502 @@
+#include "my_helpy.h"
+
+// formatting
+#define RESET        "\033[0m"
+#define BOLD         "\033[1m"
+#define ITALICS      "\033[3m"
+#define UNDERLINE    "\033[4m"
+
+// output colors
+#define RED          "\033[31m"
+#define GREEN        "\033[32m"
+#define YELLOW       "\033[33m"
+#define BLUE         "\033[34m"
+#define PURPLE       "\033[35m"
+#define CYAN         "\033[36m"
+#define WHITE        "\033[37m"
+
+// text
+#define DASHED_LINE  "- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -"
+#define BREAK        '\n' << BLUE << DASHED_LINE << RESET << '\n' << std::endl
+#define YES_NO       std::string(" (") + GREEN + "Yes" + RESET + "/" + RED + "No" + RESET + ")"
+
+// branch prediction
+#if __has_cpp_attribute(likely)
+#define LIKELY       [[likely]]
+#else
+#define LIKELY
+#endif
+
+uMap<std::string_view, long long> MyHelpy::map1 = {{"run", 1},{"print", 2},};
+uMap<std::string_view, long long> MyHelpy::map2 = {{"sorting", 3},{"search", 6},{"graph", 9},};
+uMap<std::string_view, long long> MyHelpy::map3 = {{"algorithm", 12},{"results", 24},{"stats", 36},};
+
+/**
+ * @brief The names of the commands, which identify them in usage profiles.
+ */
+static constexpr std::string_view COMMAND_NAMES[] = {
+	"run sorting algorithm",
+	"run search algorithm",
+	"print sorting results",
+	"print graph stats",
+};
+
+/**
+ * @brief The trie of the words of the commands, which is used to complete them as they are typed and to
+ * suggest commands when an unknown one is input.
+ */
+static constexpr HelpyRuntime::CommandTrie::Node COMMAND_TRIE_NODES[] = {
+	{0, 2},
+	{2, 4},
+	{4, 6},
+	{6, 7},
+	{7, 8},
+	{8, 9},
+	{9, 10},
+};
+
+static constexpr HelpyRuntime::CommandTrie::Edge COMMAND_TRIE_EDGES[] = {
+	{{"print", 5}, 1, 0x0100001000010101},
+	{{"run", 3}, 2, 0x0100000000100100},
+	{{"graph", 5}, 3, 0x0000000110000111},
+	{{"sorting", 7}, 4, 0x1100001010011100},
+	{{"search", 6}, 5, 0x0000000100102110},
+	{{"sorting", 7}, 6, 0x1100001010011100},
+	{{"stats", 5}, 0, 0x0000000000022010},
+	{{"results", 7}, 0, 0x0001000000212100},
+	{{"algorithm", 9}, 0, 0x1011001110010110},
+	{{"algorithm", 9}, 0, 0x1011001110010110},
+};
+
+/**
+ * @brief The plugin and the entry point of each command, which are loaded when the command is first executed.
+ */
+static constexpr HelpyRuntime::PluginTable::Symbol PLUGIN_SYMBOLS[] = {
+	{"my_helpy_plugin_d5ac0553", "helpy_plugin_runSortingAlgorithm"},
+	{"my_helpy_plugin_385d797f", "helpy_plugin_runSearchAlgorithm"},
+	{"my_helpy_plugin_4f447cca", "helpy_plugin_printSortingResults"},
+	{"my_helpy_plugin_99310467", "helpy_plugin_printGraphStats"}
+};
+
+/********************************************************
+	DO NOT ALTER THE METHODS BELOW!
+ ********************************************************/
+
+/**
+ * @brief Creates the command-line menu.
+ */
+MyHelpy::MyHelpy()
+	: HelpyRuntime::Console(BLUE, {COMMAND_TRIE_NODES, COMMAND_TRIE_EDGES}, "my_helpy"), usageRecorder(COMMAND_NAMES, 4), pluginTable(PLUGIN_SYMBOLS, 4) {}
+
+/**
+ * @brief Parses the arguments that were input and executes the corresponding command.
+ * @param value the value that will be used in the switch case to choose which command to execute
+ * @param job pointer to the handle that will store the job of the command, if it runs in the background,
+ * or nullptr to run every command in the foreground
+ * @return 'true' if the command exists, 'false' otherwise
+ */
+bool MyHelpy::executeCommand(long long value, HelpyRuntime::JobPool::Handle *job) {
+	HelpyRuntime::TraceScope trace("dispatch"); // the command has a span of its own
+
+	switch (value) {
+		case -1 :
+		case 16 :
+			usageRecorder.record(0);
+			trace.split(COMMAND_NAMES[0]);
+
+			if (job) *job = submitJob(COMMAND_NAMES[0], [this](const HelpyRuntime::StopToken &stop) {
+				if (auto command = loadPlugin<void (*)(MyHelpy &, const HelpyRuntime::StopToken &)>(pluginTable, 0)) command(*this, stop);
+			});
+			else if (auto command = loadPlugin<void (*)(MyHelpy &, const HelpyRuntime::StopToken &)>(pluginTable, 0)) command(*this, HelpyRuntime::StopToken());
+
+			break;
+
+		case -2 :
+		case 19 :
+			usageRecorder.record(1);
+			trace.split(COMMAND_NAMES[1]);
+			if (auto command = loadPlugin<void (*)(MyHelpy &)>(pluginTable, 1)) command(*this);
+			break;
+
+		case -3 :
+		case 29 :
+			usageRecorder.record(2);
+			trace.split(COMMAND_NAMES[2]);
+			if (auto command = loadPlugin<void (*)(MyHelpy &)>(pluginTable, 2)) command(*this);
+			break;
+
+		case -4 :
+		case 47 :
+			usageRecorder.record(3);
+			trace.split(COMMAND_NAMES[3]);
+			if (auto command = loadPlugin<void (*)(MyHelpy &)>(pluginTable, 3)) command(*this);
+			break;
+
+		default :
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Executes the advanced mode of the UI.
+ * The commands marked as ASYNC run in the background, and their jobs are managed with the built-in
+ * commands 'jobs', 'wait [id]' and 'cancel [id]'.
+ * The built-in command 'reload' reloads the plugins of the commands, e.g. after they are rebuilt.
+ * The built-in command 'bench <command> [iterations]' benchmarks a command (see benchCommand()).
+ * A line can also compose several commands, e.g. 'repeat 3 <command> & <command> ; <command>' (see
+ * HelpyRuntime::CommandGraph).
+ */
+void MyHelpy::advancedMode() {
+	// the words are views of the line buffer of the console, so reading a command allocates no memory
+	std::string_view words[5];
+
+	for (;;) {
+		// display the jobs that finished in the meantime
+		reportJobs();
+
+		size_t numWords = readCommand("How can I be of assistance?", words, 5);
+
+		if (!numWords || words[0] == "quit" || words[0] == "no" || words[0] == "die")
+			break;
+
+		// unknown words are worth 0, so they never add up to the value of a command
+		long long value = 0;
+
+		if (numWords == 3) {
+			if (auto it = map1.find(words[0]); it != map1.end()) value += it->second;
+			if (auto it = map2.find(words[1]); it != map2.end()) value += it->second;
+			if (auto it = map3.find(words[2]); it != map3.end()) value += it->second;
+		}
+
+		HelpyRuntime::JobPool::Handle job;
+
+		if (!executeCommand(value, &job)) {
+			// the built-in commands that manage the jobs only run if the words are not a command
+			if (runJobCommand(words, numWords))
+				continue;
+
+			// the built-in command that benchmarks a command only runs if the words are not a command
+			if (words[0] == "bench" && benchCommand(words + 1, numWords - 1))
+				continue;
+
+			// the lines that compose several commands only run if the words are not a command
+			if (runComposite(resolveCommand, [this](long long value) { return executeCommand(value); }))
+				continue;
+
+			// the built-in command that reloads the plugins only runs if the words are not a command
+			if (numWords == 1 && words[0] == "reload") {
+				reloadPlugins(pluginTable);
+				continue;
+			}
+
+			std::cout << BREAK;
+			std::cout << RED << "Invalid command! Please, type another command." << RESET << std::endl;
+
+			if (std::string_view suggestion = suggestCommand(words, numWords); !suggestion.empty())
+				std::cout << suggestion << std::endl;
+
+			continue;
+		}
+
+		// the commands that run in the background do not hold the prompt
+		if (job)
+			continue;
+
+		// ask the user if they want to execute another command
+		if (!MyHelpy::readYesOrNo("Anything else?"))
+			break;
+	}
+
+	// the jobs may use the object, so they must finish before it is destroyed
+	finishJobs();
+}
+
+/**
+ * @brief Benchmarks a command, which is executed repeatedly with its output discarded, and displays its
+ * latency, throughput and heap allocations (see HelpyRuntime::Benchmark). The executions are not recorded
+ * as usage of the command.
+ * @param words the words of the command, optionally followed by the number of iterations
+ * @param numWords the number of words
+ * @return 'true' if the words are a command, 'false' otherwise
+ */
+bool MyHelpy::benchCommand(const std::string_view *words, size_t numWords) {
+	// if the number of iterations is not specified, the command runs for about a second
+	size_t iterations = 0;
+
+	if (numWords == 4) {
+		if (!Utils::parseNumber(words[3], iterations) || !iterations)
+			return false;
+	}
+	else if (numWords != 3)
+		return false;
+
+	// unknown words are worth 0, so they never add up to the value of a command
+	long long value = 0;
+
+	if (auto it = map1.find(words[0]); it != map1.end()) value += it->second;
+	if (auto it = map2.find(words[1]); it != map2.end()) value += it->second;
+	if (auto it = map3.find(words[2]); it != map3.end()) value += it->second;
+
+	size_t executions = benchmark([this, value] { return executeCommand(value); }, iterations);
+	if (!executions)
+		return false;
+
+	usageRecorder.discard(usageRecorder.last(), executions);
+	return true;
+}
+
+/**
+ * @brief Resolves the words of a command to its value, which identifies it (see executeCommand()).
+ * @param words the words of the command, in lowercase
+ * @param numWords the number of words
+ * @return the value of the command, or 0 if the words are not a command
+ */
+long long MyHelpy::resolveCommand(const std::string_view *words, size_t numWords) {
+	if (numWords != 3)
+		return 0;
+
+	// unknown words are worth 0, so they never add up to the value of a command
+	long long value = 0;
+
+	if (auto it = map1.find(words[0]); it != map1.end()) value += it->second;
+	if (auto it = map2.find(words[1]); it != map2.end()) value += it->second;
+	if (auto it = map3.find(words[2]); it != map3.end()) value += it->second;
+
+	switch (value) {
+		case 16 :
+		case 19 :
+		case 29 :
+		case 47 :
+			return value;
+
+		default :
+			return 0;
+	}
+}
+
+/**
+ * @brief The menu of the guided mode, which is rendered when the code is generated so displaying it
+ * requires no allocations. The plain version is used when the output is not a terminal.
+ */
+static constexpr std::string_view GUIDED_MENU =
+	"How can I be of assistance?\n\n"
+	BOLD BLUE "1 - " WHITE "run sorting algorithm\n" RESET ITALICS "Sorts \"things\"\nfast\n" RESET "\n"
+	BOLD BLUE "2 - " WHITE "run search algorithm\n" RESET "\n"
+	BOLD BLUE "3 - " WHITE "print sorting results\n" RESET ITALICS "Prints results\n" RESET "\n"
+	BOLD BLUE "4 - " WHITE "print graph stats" RESET;
+
+static constexpr std::string_view GUIDED_MENU_PLAIN =
+	"How can I be of assistance?\n\n"
+	"1 - run sorting algorithm\nSorts \"things\"\nfast\n\n"
+	"2 - run search algorithm\n\n"
+	"3 - print sorting results\nPrints results\n\n"
+	"4 - print graph stats";
+
+/**
+ * @brief Executes the guided mode of the UI.
+ */
+void MyHelpy::guidedMode() {
+	std::string_view instruction = colorsEnabled() ? GUIDED_MENU : GUIDED_MENU_PLAIN;
+
+	for (;;) {
+		int num = (int) -readNumber(instruction);
+		if (!executeCommand(num)) {
+			std::cout << BREAK;
+			std::cout << RED << "Invalid command! Please, type another command." << RESET << std::endl;
+			continue;
+		}
+
+		// ask the user if they want to execute another command
+		if (!MyHelpy::readYesOrNo("Anything else?"))
+			break;
+	}
+}
+
+/**
+ * @brief Runs the command-line menu.
+ */
+void MyHelpy::run() {
+	std::string instruction = "Which mode would you prefer?\n\n"
+                            BLUE "* " RESET "Guided\n"
+                            BLUE "* " RESET "Advanced";
+
+	(readInput(instruction, {"guided", "advanced", "adv"}) == "guided")
+		? MyHelpy::guidedMode()
+		: MyHelpy::advancedMode();
+
+	std::cout << BREAK;
+	std::cout << "See you next time!\n" << std::endl;
+}
+
+/**
+ * @brief Executes the commands of a script, one per line, without any user interaction. Invalid lines
+ * are reported and skipped, and a summary is printed at the end.
+ * @param path the path to the script, or nullptr to read the script from the standard input
+ * @param timings boolean indicating if the execution time of each command should be reported
+ * @return the exit status of the program, which signals failure if any line is invalid
+ */
+int MyHelpy::runScript(const char *path, bool timings) {
+	HelpyRuntime::Script script(path);
+
+	if (!script.isOpen()) {
+		std::cerr << "Could not open the script '" << path << "'!" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	HelpyRuntime::ScriptReport report(COMMAND_NAMES, 4, timings);
+
+	std::string_view line, words[4];
+	std::string lowercase; // the line in lowercase, whose buffer is reused to avoid allocations
+
+	for (size_t number = 1; script.nextLine(line); ++number) {
+		lowercase.assign(line); Utils::toLowercase(lowercase);
+
+		size_t numWords = HelpyRuntime::Script::split(lowercase, words, 4);
+		if (!numWords) continue; // blank line or comment
+
+		// unknown words are worth 0, so they never add up to the value of a command
+		long long value = 0;
+
+		if (numWords == 3) {
+			if (auto it = map1.find(words[0]); it != map1.end()) value += it->second;
+			if (auto it = map2.find(words[1]); it != map2.end()) value += it->second;
+			if (auto it = map3.find(words[2]); it != map3.end()) value += it->second;
+		}
+
+		report.start();
+
+		(executeCommand(value))
+			? report.finish(usageRecorder.last())
+			: report.fail(number, line, suggestCommand(words, numWords));
+	}
+
+	report.print();
+	return report.failures() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * @brief Executes a line sent by a client of the server, with the same tables as the other modes. Lines
+ * sent by different clients are executed concurrently, so the commands must be thread-safe unless the
+ * server has a single worker.
+ * @param line the line
+ * @return 'true' if the line is a command, 'false' otherwise
+ */
+bool MyHelpy::executeLine(std::string_view line) {
+	std::string lowercase(line); Utils::toLowercase(lowercase);
+
+	std::string_view words[4];
+	size_t numWords = HelpyRuntime::Script::split(lowercase, words, 4);
+
+	// unknown words are worth 0, so they never add up to the value of a command
+	long long value = 0;
+
+	if (numWords == 3) {
+		if (auto it = map1.find(words[0]); it != map1.end()) value += it->second;
+		if (auto it = map2.find(words[1]); it != map2.end()) value += it->second;
+		if (auto it = map3.find(words[2]); it != map3.end()) value += it->second;
+	}
+
+	return executeCommand(value);
+}
+
+/**
+ * @brief Runs the program according to the command-line arguments, which may be:
+ * - a command, which is executed without any user interaction;
+ * - '--script <file>', which executes the commands of a script (see runScript());
+ * - nothing, in which case the command-line menu is run or, if the standard input is not a terminal,
+ * the commands are read from it as a script.
+ * The option '--timings' reports the execution time of the commands of a script, and the option
+ * '--trace <file>' saves a trace of the execution to a file, in the Chrome trace-event format.
+ * The option '--serve <socket>' serves clients over a Unix domain socket instead (see executeLine()),
+ * with as many workers as the option '--workers <n>' specifies (by default, one per hardware thread).
+ * The option '--record <file>' runs the command-line menu and saves the transcript of the session, and
+ * the option '--replay <path>' replays the transcripts in a file or directory in parallel, with the same
+ * workers, and verifies if their output is unchanged (see HelpyRuntime::Replayer).
+ * @param argc the number of command-line arguments
+ * @param argv the command-line arguments, the first of which is the name of the program
+ * @return the exit status of the program
+ */
+int MyHelpy::run(int argc, char **argv) {
+	const char *script = nullptr, *trace = nullptr, *server = nullptr, *record = nullptr, *replay = nullptr;
+	unsigned workers = 0;
+	bool timings = false;
+
+	// parse the options
+	int first = 1;
+
+	for (; first < argc; ++first) {
+		std::string_view option = argv[first];
+
+		if (option == "--script" && first + 1 < argc)
+			script = argv[++first];
+		else if (option == "--timings")
+			timings = true;
+		else if (option == "--trace" && first + 1 < argc)
+			trace = argv[++first];
+		else if (option == "--serve" && first + 1 < argc)
+			server = argv[++first];
+		else if (option == "--workers" && first + 1 < argc)
+			workers = (unsigned) strtoul(argv[++first], nullptr, 10);
+		else if (option == "--record" && first + 1 < argc)
+			record = argv[++first];
+		else if (option == "--replay" && first + 1 < argc)
+			replay = argv[++first];
+		else
+			break;
+	}
+
+	// the trace is saved when the recorder is destroyed, however the program ends
+	HelpyRuntime::TraceRecorder traceRecorder(trace);
+
+	if (server) {
+		return serve(server, workers, [this](std::string_view line) { return executeLine(line); });
+	}
+
+	if (record || replay) {
+		// each session runs in an instance of its own
+		auto session = [] { MyHelpy helpy; helpy.run(); };
+		return record ? recordSession(record, session) : replaySessions(replay, workers, session);
+	}
+
+	int numWords = argc - first;
+
+	if (script || (!numWords && !interactive()))
+		return runScript(script, timings);
+
+	if (!numWords) {
+		run();
+		return EXIT_SUCCESS;
+	}
+
+	// unknown words are worth 0, so they never add up to the value of a command
+	long long value = 0;
+
+	std::string_view words[3];
+
+	if (numWords == 3) {
+		// the words are turned into lowercase in place
+		for (int i = 0; i < 3; ++i) {
+			words[i] = argv[first + i];
+			Utils::toLowercase(argv[first + i], words[i].size());
+		}
+
+		if (auto it = map1.find(words[0]); it != map1.end()) value += it->second;
+		if (auto it = map2.find(words[1]); it != map2.end()) value += it->second;
+		if (auto it = map3.find(words[2]); it != map3.end()) value += it->second;
+	}
+
+	if (!executeCommand(value)) {
+		std::cerr << "Invalid command!" << std::endl;
+
+		if (numWords == 3) {
+			if (std::string_view suggestion = suggestCommand(words, numWords); !suggestion.empty())
+				std::cerr << suggestion << std::endl;
+		}
+
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+#ifndef MY_HELPY_H
+#define MY_HELPY_H
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "helpy_runtime.h"
+
+#if HELPY_RUNTIME_VERSION_MAJOR != 1
+#error "This file was generated for version 1 of the Helpy runtime!"
+#endif
+
+#define uMap std::unordered_map
+#define uSet std::unordered_set
+
+namespace Utils = HelpyRuntime::Utils;
+
+class MyHelpy;
+
+// the entry points of the commands, which are defined by the plugins (see HelpyRuntime::PluginTable)
+extern "C" {
+void helpy_plugin_runSortingAlgorithm(MyHelpy &self, const HelpyRuntime::StopToken &stop);
+void helpy_plugin_runSearchAlgorithm(MyHelpy &self);
+void helpy_plugin_printSortingResults(MyHelpy &self);
+void helpy_plugin_printGraphStats(MyHelpy &self);
+}
+
+class MyHelpy : public HelpyRuntime::Console {
+	static uMap<std::string_view, long long> map1, map2, map3;
+	HelpyRuntime::UsageRecorder usageRecorder;
+	HelpyRuntime::PluginTable pluginTable;
+
+	/* METHODS */
+	// commands
+	void runSortingAlgorithm(const HelpyRuntime::StopToken &stop);
+	void runSearchAlgorithm();
+	void printSortingResults();
+	void printGraphStats();
+
+	// the entry points of the plugins, which call the commands
+	friend void helpy_plugin_runSortingAlgorithm(MyHelpy &self, const HelpyRuntime::StopToken &stop);
+	friend void helpy_plugin_runSearchAlgorithm(MyHelpy &self);
+	friend void helpy_plugin_printSortingResults(MyHelpy &self);
+	friend void helpy_plugin_printGraphStats(MyHelpy &self);
+
+	// DO NOT ALTER THE DECLARATIONS BELOW!
+	bool executeCommand(long long value, HelpyRuntime::JobPool::Handle *job = nullptr);
+	void advancedMode();
+	bool benchCommand(const std::string_view *words, size_t numWords);
+	static long long resolveCommand(const std::string_view *words, size_t numWords);
+	void guidedMode();
+	int runScript(const char *path, bool timings);
+	bool executeLine(std::string_view line);
+
+public:
+	MyHelpy();
+	void run();
+	int run(int argc, char **argv);
+};
+
+#endif
@@ -0,0 +1,44 @@
+#include "my_helpy.h"
+
+// formatting
+#define RESET        "\033[0m"
+#define BOLD         "\033[1m"
+#define ITALICS      "\033[3m"
+#define UNDERLINE    "\033[4m"
+
+// output colors
+#define RED          "\033[31m"
+#define GREEN        "\033[32m"
+#define YELLOW       "\033[33m"
+#define BLUE         "\033[34m"
+#define PURPLE       "\033[35m"
+#define CYAN         "\033[36m"
+#define WHITE        "\033[37m"
+
+// text
+#define DASHED_LINE  "- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -"
+#define BREAK        '\n' << BLUE << DASHED_LINE << RESET << '\n' << std::endl
+#define YES_NO       std::string(" (") + GREEN + "Yes" + RESET + "/" + RED + "No" + RESET + ")"
+
+// branch prediction
+#if __has_cpp_attribute(likely)
+#define LIKELY       [[likely]]
+#else
+#define LIKELY
+#endif
+
+/**
+ * @brief Sorts "things"
+ * fast
+ * @param stop the token that signals the cancellation of the command, which runs in the background in
+ * the advanced mode and should return soon after stop.stopRequested() becomes 'true'
+ */
+void MyHelpy::runSortingAlgorithm(const HelpyRuntime::StopToken &stop) {
+	std::cout << BREAK;
+	std::cout << "Under development!" << std::endl;
+}
+
+// the entry points of the plugin, which the program resolves when the commands are first executed
+extern "C" HELPY_PLUGIN_EXPORT void helpy_plugin_runSortingAlgorithm(MyHelpy &self, const HelpyRuntime::StopToken &stop) {
+	self.runSortingAlgorithm(stop);
+}
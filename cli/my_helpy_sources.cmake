@@ -0,0 +1,38 @@
+# The source files of MyHelpy, to be included by CMake projects.
+set(MY_HELPY_SOURCES
+        ${CMAKE_CURRENT_LIST_DIR}/my_helpy.cpp)
+
+# the source files of the plugins, each of which holds some of the commands
+set(MY_HELPY_PLUGINS
+        ${CMAKE_CURRENT_LIST_DIR}/my_helpy_plugin_d5ac0553.cpp
+        ${CMAKE_CURRENT_LIST_DIR}/my_helpy_plugin_385d797f.cpp
+        ${CMAKE_CURRENT_LIST_DIR}/my_helpy_plugin_4f447cca.cpp
+        ${CMAKE_CURRENT_LIST_DIR}/my_helpy_plugin_99310467.cpp)
+
+# builds the plugins next to a target, which exports the runtime to them, e.g.
+# my_helpy_add_plugins(<target>)
+function(my_helpy_add_plugins target)
+    set_target_properties(${target} PROPERTIES ENABLE_EXPORTS ON)
+    target_link_options(${target} PRIVATE
+            LINKER:--whole-archive $<TARGET_FILE:helpy_runtime> LINKER:--no-whole-archive)
+    get_target_property(standard ${target} CXX_STANDARD)
+
+    foreach (source ${MY_HELPY_PLUGINS})
+        get_filename_component(plugin ${source} NAME_WE)
+
+        add_library(${plugin} MODULE ${source})
+        target_include_directories(${plugin} PRIVATE
+                $<TARGET_PROPERTY:helpy_runtime,INTERFACE_INCLUDE_DIRECTORIES>)
+        set_target_properties(${plugin} PROPERTIES
+                PREFIX ""
+                SUFFIX ".so"
+                CXX_VISIBILITY_PRESET hidden
+                LIBRARY_OUTPUT_DIRECTORY $<TARGET_FILE_DIR:${target}>)
+
+        if (standard)
+            set_target_properties(${plugin} PROPERTIES CXX_STANDARD ${standard})
+        endif ()
+
+        add_dependencies(${target} ${plugin})
+    endforeach ()
+endfunction()
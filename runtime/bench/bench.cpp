@@ -0,0 +1,321 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#define HELPY_PERF_EVENTS
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "../io/io.h"
+#include "../utils/ticks.h"
+
+// the time a benchmark runs for if the number of iterations is not specified, in nanoseconds
+#define BENCHMARK_TIME 1e9
+
+// the bounds of the number of iterations of a benchmark whose number of iterations is not specified
+#define MIN_ITERATIONS 10
+#define MAX_ITERATIONS 1000000
+
+using Clock = std::chrono::steady_clock;
+
+#ifndef HELPY_NO_ALLOCATION_COUNTING
+// the number of heap allocations made by each thread
+static thread_local uint64_t numAllocations_ = 0;
+
+/*
+ * The replacements of the global allocation functions, which count the allocations. The forms that are not replaced
+ * (e.g. the array and nothrow forms) call these, so every allocation is counted once, except over-aligned ones.
+ */
+void *operator new(size_t size) {
+    ++numAllocations_;
+
+    for (;;) {
+        if (void *pointer = std::malloc(size ? size : 1)) return pointer;
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+
+        handler();
+    }
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    std::free(pointer);
+}
+#endif
+
+namespace HelpyRuntime {
+#ifdef HELPY_PERF_EVENTS
+    /**
+     * @brief The counters of the processor of a benchmark, which count the events of the calling thread in user space.
+     * They are opened as a group, so they are enabled, disabled and read at once.
+     */
+    class PerfCounters {
+        int fds[Benchmark::NUM_COUNTERS];
+
+    /* CONSTRUCTOR */
+    public:
+        PerfCounters() {
+            std::fill(fds, fds + Benchmark::NUM_COUNTERS, -1);
+
+            static constexpr uint64_t EVENTS[] = {PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+
+            for (int i = 0; i < Benchmark::NUM_COUNTERS; ++i) {
+                perf_event_attr attributes{};
+                attributes.type = PERF_TYPE_HARDWARE;
+                attributes.size = sizeof(attributes);
+                attributes.config = EVENTS[i];
+                attributes.disabled = !i; // the members of the group follow its leader
+                attributes.exclude_kernel = 1;
+                attributes.exclude_hv = 1;
+                attributes.read_format = PERF_FORMAT_GROUP;
+
+                fds[i] = (int) syscall(SYS_perf_event_open, &attributes, 0, -1, i ? fds[0] : -1, PERF_FLAG_FD_CLOEXEC);
+
+                // the counters are often unavailable (e.g. in virtual machines or due to perf_event_paranoid)
+                if (fds[i] < 0) {
+                    close();
+                    return;
+                }
+            }
+        }
+
+        PerfCounters(const PerfCounters &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~PerfCounters() {
+            close();
+        }
+
+    /* METHODS */
+    private:
+        void close() {
+            for (int &fd : fds) {
+                if (fd >= 0) ::close(fd);
+                fd = -1;
+            }
+        }
+
+    public:
+        [[nodiscard]] bool available() const {
+            return fds[0] >= 0;
+        }
+
+        void start() {
+            ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+
+        /**
+         * @brief Stops the counters and reads them.
+         * @param values array which will store the value of each counter
+         * @return 'true' if the counters were read, 'false' otherwise
+         */
+        bool stop(uint64_t *values) {
+            ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+            uint64_t group[1 + Benchmark::NUM_COUNTERS];
+            if (read(fds[0], group, sizeof(group)) != (ssize_t) sizeof(group)) return false;
+
+            std::copy(group + 1, group + 1 + Benchmark::NUM_COUNTERS, values);
+            return true;
+        }
+    };
+#endif
+
+    /**
+     * @brief Creates a benchmark.
+     * @param iterations the number of executions that are measured, or 0 to measure as many as fit in about a second
+     * (see BENCHMARK_TIME)
+     */
+    Benchmark::Benchmark(size_t iterations)
+        : numIterations(iterations), numWarmup(0), numExecutions(0), nanosecondsPerTick(1), seconds(0),
+          numAllocations(0), counters(), hasCounters(false) {}
+
+    /**
+     * @brief Verifies if the heap allocations are counted (see HELPY_NO_ALLOCATION_COUNTING).
+     * @return 'true' if the allocations are counted, 'false' otherwise
+     */
+    bool Benchmark::countsAllocations() {
+#ifndef HELPY_NO_ALLOCATION_COUNTING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Returns the number of heap allocations made by the calling thread so far.
+     * @return the number of allocations, which is always 0 if they are not counted
+     */
+    uint64_t Benchmark::allocations() {
+#ifndef HELPY_NO_ALLOCATION_COUNTING
+        return numAllocations_;
+#else
+        return 0;
+#endif
+    }
+
+    /**
+     * @brief Computes a percentile of the latency of the executions.
+     * @param percentile the percentile, between 0 and 100
+     * @return the latency, in nanoseconds
+     */
+    double Benchmark::percentile(double percentile) const {
+        auto rank = (size_t) std::ceil(percentile / 100 * (double) ticks.size());
+        return (double) ticks[std::clamp<size_t>(rank, 1, ticks.size()) - 1] * nanosecondsPerTick;
+    }
+
+    /**
+     * @brief Runs the benchmark. The first execution determines if the command exists. Then, the command is warmed
+     * up, which fills the caches and trains the branch predictors, before the iterations are measured. If the number
+     * of iterations was not specified, the warmup lasts a hundredth of the time of the benchmark and estimates how
+     * many iterations fit in it; otherwise, it takes a tenth of the iterations.
+     * @param command the function that executes the command (e.g. calls the executeCommand() method of the
+     * generated class), which returns 'false' if the command does not exist
+     * @return 'true' if the command exists, 'false' otherwise
+     */
+    bool Benchmark::run(const std::function<bool()> &command) {
+        std::string output;
+        IO::Capture capture(output);
+
+        IO::Feed feed([](std::string &) -> bool {
+            throw std::runtime_error("the command reads input, which a benchmark cannot provide");
+        });
+
+        Utils::TickConverter converter;
+
+        ++numExecutions;
+        if (!command()) return false;
+
+        output.clear();
+
+        if (numIterations) {
+            for (; numWarmup < numIterations / 10; ++numWarmup) {
+                ++numExecutions;
+                command();
+                output.clear();
+            }
+        }
+        else {
+            auto start = Clock::now();
+            double elapsed = 0;
+
+            for (; elapsed < BENCHMARK_TIME / 100 && numWarmup < MAX_ITERATIONS; ++numWarmup) {
+                ++numExecutions;
+                command();
+                output.clear();
+
+                elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            }
+
+            numIterations = (size_t) std::clamp(BENCHMARK_TIME * (double) numWarmup / elapsed,
+                                                (double) MIN_ITERATIONS, (double) MAX_ITERATIONS);
+        }
+
+        // the latencies are stored before the measurements start, so storing them allocates no memory
+        ticks.resize(numIterations);
+
+#ifdef HELPY_PERF_EVENTS
+        PerfCounters perf;
+        if (perf.available()) perf.start();
+#endif
+
+        uint64_t allocations_ = allocations();
+        auto startTime = Clock::now();
+
+        for (uint64_t &ticks_ : ticks) {
+            ++numExecutions;
+            uint64_t start = Utils::readTicks();
+
+            command();
+
+            ticks_ = Utils::readTicks() - start;
+            output.clear();
+        }
+
+        seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+        numAllocations = allocations() - allocations_;
+
+#ifdef HELPY_PERF_EVENTS
+        hasCounters = perf.available() && perf.stop(counters);
+#endif
+
+        nanosecondsPerTick = converter.nanosecondsPerTick();
+        std::sort(ticks.begin(), ticks.end());
+
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of times the command was executed, including the warmup.
+     * @return the number of executions
+     */
+    size_t Benchmark::executions() const {
+        return numExecutions;
+    }
+
+    /**
+     * @brief Appends a row of the report of a benchmark to a string.
+     * @param out the string
+     * @param name the name of the row
+     * @param number the value of the row
+     * @param precision the number of decimal places of the value
+     */
+    static void appendRow(std::string &out, std::string_view name, double number, int precision) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), number, std::chars_format::fixed, precision);
+
+        if (!out.empty()) out += '\n';
+        out += name;
+        out.append(std::max<size_t>(1, 24 - name.size()), ' ');
+        out.append(digits, result.ptr - digits);
+    }
+
+    /**
+     * @brief Renders the results of the benchmark as a table, with the latencies in microseconds.
+     * @return the table, which does not end with a newline
+     */
+    std::string Benchmark::report() const {
+        std::string out;
+        if (ticks.empty()) return out;
+
+        auto iterations = (double) ticks.size();
+
+        appendRow(out, "Iterations", iterations, 0);
+        out += " (after " + std::to_string(numWarmup + 1) + " warmup executions)";
+
+        appendRow(out, "Min (us)", (double) ticks.front() * nanosecondsPerTick / 1e3, 3);
+        appendRow(out, "Median (us)", percentile(50) / 1e3, 3);
+        appendRow(out, "p99 (us)", percentile(99) / 1e3, 3);
+        appendRow(out, "Max (us)", (double) ticks.back() * nanosecondsPerTick / 1e3, 3);
+        appendRow(out, "Ops/s", seconds > 0 ? iterations / seconds : 0, 0);
+
+        if (countsAllocations())
+            appendRow(out, "Allocations/op", (double) numAllocations / iterations, 2);
+
+        if (hasCounters) {
+            appendRow(out, "Instructions/op", (double) counters[INSTRUCTIONS] / iterations, 0);
+            appendRow(out, "Cache misses/op", (double) counters[CACHE_MISSES] / iterations, 2);
+        }
+        else out += "\n(the performance counters of the processor are unavailable)";
+
+        return out;
+    }
+}
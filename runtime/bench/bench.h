@@ -0,0 +1,50 @@
+#ifndef HELPY_RUNTIME_BENCH_H
+#define HELPY_RUNTIME_BENCH_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace HelpyRuntime {
+    /**
+     * @brief Benchmarks a command, which is executed repeatedly with its output discarded and its input closed, so
+     * commands that read input cannot be benchmarked. After a warmup, the latency of each execution is measured, as
+     * well as the heap allocations and, if the kernel allows it, the instructions and cache misses of the executions.
+     *
+     * The allocations are counted by replacing the global operator new, which only adds an increment of a thread-local
+     * counter to each allocation. Programs that replace it themselves must define HELPY_NO_ALLOCATION_COUNTING when
+     * compiling the runtime.
+     */
+    class Benchmark {
+    public:
+        // the counters of the processor that are read during the benchmark, if possible (see perf_event_open(2))
+        enum Counter { INSTRUCTIONS, CACHE_MISSES, NUM_COUNTERS };
+
+    private:
+        size_t numIterations, numWarmup, numExecutions;
+        std::vector<uint64_t> ticks; // the latency of each measured execution, in ticks (see Utils::readTicks())
+        double nanosecondsPerTick, seconds;
+        uint64_t numAllocations;
+        uint64_t counters[NUM_COUNTERS];
+        bool hasCounters;
+
+    /* CONSTRUCTOR */
+    public:
+        explicit Benchmark(size_t iterations = 0);
+
+    /* METHODS */
+    private:
+        [[nodiscard]] double percentile(double percentile) const;
+
+    public:
+        static bool countsAllocations();
+        static uint64_t allocations();
+
+        bool run(const std::function<bool()> &command);
+        [[nodiscard]] size_t executions() const;
+        [[nodiscard]] std::string report() const;
+    };
+}
+
+#endif //HELPY_RUNTIME_BENCH_H
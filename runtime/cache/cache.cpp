@@ -0,0 +1,381 @@
+#include "cache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// the maximum size of the cache file, past which the least recently used entries are evicted
+#define MAX_CACHE_SIZE (64 << 20)
+
+// the size of the cache file after the eviction
+#define COMPACTED_SIZE (MAX_CACHE_SIZE / 2)
+
+// the maximum size of a segment of output, as larger segments are not worth caching
+#define MAX_ENTRY_SIZE (1 << 20)
+
+// the number of times a lock is attempted, in case other processes keep replacing the file
+#define MAX_ATTEMPTS 3
+
+namespace HelpyRuntime {
+    /**
+     * @brief The header of the cache file.
+     */
+    struct FileHeader {
+        char magic[8];
+        uint64_t build; // the identifier of the executable that wrote the file
+    };
+
+    /**
+     * @brief The header of an entry of the cache file, which is followed by the output, padded to 8 bytes.
+     */
+    struct EntryHeader {
+        uint64_t key;
+        uint32_t length;
+        uint32_t final;
+    };
+
+    static constexpr char MAGIC[8] = {'H', 'E', 'L', 'P', 'Y', 'R', 'C', '1'};
+
+    /**
+     * @brief Computes the size an entry takes in the cache file.
+     * @param length the length of the output
+     * @return the size of the entry
+     */
+    static size_t entrySize(size_t length) {
+        return sizeof(EntryHeader) + ((length + 7) & ~(size_t) 7);
+    }
+
+    /**
+     * @brief Identifies the executable of the calling process, so the entries written by other builds are discarded.
+     * @return the identifier, which is 0 if the executable cannot be identified
+     */
+    static uint64_t identifyBuild() {
+        struct stat executable{};
+        if (stat("/proc/self/exe", &executable)) return 0;
+
+        uint64_t fields[] = {(uint64_t) executable.st_mtime, (uint64_t) executable.st_size, (uint64_t) executable.st_ino};
+        return ResultCache::hash(std::string_view((const char *) fields, sizeof(fields)));
+    }
+
+    /**
+     * @brief Writes data to a file descriptor, retrying if the write is interrupted or partial.
+     * @param fd the file descriptor
+     * @param data the data
+     * @param size the size of the data
+     * @return 'true' if the data was written, 'false' otherwise
+     */
+    static bool writeAll(int fd, const char *data, size_t size) {
+        while (size) {
+            ssize_t written = ::write(fd, data, size);
+
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+
+            data += written;
+            size -= written;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Creates the cache. The file is only opened when the first command is looked up.
+     * @param name the name of the program, which names the file
+     */
+    ResultCache::ResultCache(const char *name)
+        : fd(-1), data(nullptr), mapped(0), scanned(0), build(identifyBuild()), clock(0) {
+        const char *path_ = getenv("HELPY_CACHE");
+        const char *home = getenv("HOME");
+
+        if (path_ && *path_)
+            path = path_;
+        else if (home && *home)
+            path = std::string(home) + "/." + name + "_cache";
+    }
+
+    /**
+     * @brief Closes the cache file.
+     */
+    ResultCache::~ResultCache() {
+        close();
+    }
+
+    /**
+     * @brief Computes the FNV-1a hash of a line, followed by a newline, so the hashes of different sequences of lines
+     * differ. The key of a segment of output is the hash of the name of the command, used as the seed of the hash of
+     * the first line of input, and so on.
+     * @param text the line, which must not contain newlines
+     * @param seed the hash of the previous lines
+     * @return the hash
+     */
+    uint64_t ResultCache::hash(std::string_view text, uint64_t seed) {
+        for (char c : text) {
+            seed ^= (uint8_t) c;
+            seed *= 0x100000001b3;
+        }
+
+        seed ^= '\n';
+        return seed * 0x100000001b3;
+    }
+
+    /**
+     * @brief Opens the cache file and indexes its entries. If the file was written by another build, or its last entry
+     * is torn (e.g. because the program was killed while writing it), it is replaced, rather than truncated, as other
+     * processes may have mapped it.
+     * @return 'true' if the file was opened, 'false' if it was replaced or could not be opened
+     */
+    bool ResultCache::open() {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+
+        if (fd < 0) {
+            path.clear(); // the cache is disabled
+            return false;
+        }
+
+        flock(fd, LOCK_EX);
+
+        struct stat file{};
+        fstat(fd, &file);
+
+        FileHeader header{};
+
+        if (!file.st_size) {
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.build = build;
+
+            if (!writeAll(fd, (const char *) &header, sizeof(header))) {
+                close();
+                return false;
+            }
+
+            file.st_size = sizeof(header);
+        }
+        else if (pread(fd, &header, sizeof(header), 0) != (ssize_t) sizeof(header))
+            header = {};
+
+        if (!std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) && header.build == build && map(file.st_size)) {
+            scanned = sizeof(header);
+            scan();
+
+            if (scanned == (size_t) file.st_size) {
+                flock(fd, LOCK_UN);
+                return true;
+            }
+        }
+
+        rewrite(MAX_CACHE_SIZE);
+        close();
+
+        return false;
+    }
+
+    /**
+     * @brief Closes the cache file, which also releases its lock, and clears the index.
+     */
+    void ResultCache::close() {
+        if (data) munmap((void *) data, mapped);
+        if (fd >= 0) ::close(fd);
+
+        fd = -1;
+        data = nullptr;
+        mapped = scanned = 0;
+        index.clear();
+    }
+
+    /**
+     * @brief Locks the cache file and indexes the entries that other processes appended to it. If the file was
+     * replaced by another process, the new file is opened instead.
+     * @param operation the kind of lock (LOCK_SH or LOCK_EX)
+     * @return 'true' if the file was locked, 'false' otherwise
+     */
+    bool ResultCache::lock(int operation) {
+        for (int attempt = 0; attempt < MAX_ATTEMPTS && !path.empty(); ++attempt) {
+            if (fd < 0 && !open()) continue;
+
+            flock(fd, operation);
+            struct stat file{}, opened{};
+
+            if (!stat(path.c_str(), &file) && !fstat(fd, &opened) && file.st_dev == opened.st_dev
+                && file.st_ino == opened.st_ino) {
+                if ((size_t) opened.st_size > scanned && map(opened.st_size)) scan();
+                return true;
+            }
+
+            close();
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Maps the cache file into memory, if it grew since it was last mapped.
+     * @param size the size of the file
+     * @return 'true' if the file is mapped, 'false' otherwise
+     */
+    bool ResultCache::map(size_t size) {
+        if (size <= mapped) return true;
+
+        if (data) munmap((void *) data, mapped);
+        void *data_ = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+
+        if (data_ == MAP_FAILED) {
+            data = nullptr;
+            mapped = scanned = 0;
+            index.clear();
+
+            return false;
+        }
+
+        data = (const char *) data_;
+        mapped = size;
+
+        return true;
+    }
+
+    /**
+     * @brief Indexes the entries of the mapped file that are not indexed yet. Later entries replace earlier entries
+     * with the same key, and the order of the entries is the order in which they were used (see rewrite()).
+     */
+    void ResultCache::scan() {
+        while (scanned + sizeof(EntryHeader) <= mapped) {
+            EntryHeader header{};
+            std::memcpy(&header, data + scanned, sizeof(header));
+
+            // the entry is torn
+            if (header.length > MAX_ENTRY_SIZE || header.final > 1 || scanned + entrySize(header.length) > mapped)
+                break;
+
+            index[header.key] = {scanned + sizeof(header), header.length, (bool) header.final, ++clock};
+            scanned += entrySize(header.length);
+        }
+    }
+
+    /**
+     * @brief Writes the most recently used entries to a new file, which replaces the cache file. The entries are
+     * written from the least to the most recently used, so the order survives restarts. The file must be locked
+     * exclusively.
+     * @param limit the maximum size of the new file
+     */
+    void ResultCache::rewrite(size_t limit) {
+        std::vector<std::pair<uint64_t, const Entry *>> entries;
+        entries.reserve(index.size());
+
+        for (const auto &[key, entry] : index)
+            entries.emplace_back(key, &entry);
+
+        std::sort(entries.begin(), entries.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.second->lastUse > rhs.second->lastUse;
+        });
+
+        // keep the most recently used entries that fit
+        size_t size = sizeof(FileHeader), kept = 0;
+
+        for (; kept < entries.size() && size + entrySize(entries[kept].second->length) <= limit; ++kept)
+            size += entrySize(entries[kept].second->length);
+
+        std::string contents;
+        contents.reserve(size);
+
+        FileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.build = build;
+        contents.append((const char *) &header, sizeof(header));
+
+        while (kept--) {
+            const auto &[key, entry] = entries[kept];
+            EntryHeader entryHeader = {key, entry->length, entry->final};
+
+            contents.append((const char *) &entryHeader, sizeof(entryHeader));
+            contents.append(data + entry->offset, entry->length);
+            contents.resize(contents.size() + entrySize(entry->length) - sizeof(entryHeader) - entry->length, '\0');
+        }
+
+        std::string temporary = path + ".tmp";
+        int out = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (out < 0) return;
+
+        bool written = writeAll(out, contents.data(), contents.size());
+        ::close(out);
+
+        if (!written || rename(temporary.c_str(), path.c_str()))
+            unlink(temporary.c_str());
+    }
+
+    /**
+     * @brief Looks up a segment of output.
+     * @param key the key of the segment (see hash())
+     * @param output string which will store the segment
+     * @param final variable which will store if the segment is the last segment of the command
+     * @return 'true' if the segment is cached, 'false' otherwise
+     */
+    bool ResultCache::find(uint64_t key, std::string &output, bool &final) {
+        std::lock_guard<std::mutex> guard(mutex);
+        auto it = index.find(key);
+
+        // the segment may have been cached by another process
+        if (it == index.end()) {
+            if (!lock(LOCK_SH)) return false;
+
+            flock(fd, LOCK_UN);
+            if ((it = index.find(key)) == index.end()) return false;
+        }
+
+        Entry &entry = it->second;
+        output.assign(data + entry.offset, entry.length);
+
+        final = entry.final;
+        entry.lastUse = ++clock;
+
+        return true;
+    }
+
+    /**
+     * @brief Appends a segment of output to the cache file, evicting the least recently used entries if the file
+     * becomes too large.
+     * @param key the key of the segment (see hash())
+     * @param output the segment
+     * @param final boolean indicating if the segment is the last segment of the command
+     * @return 'true' if the segment was cached, 'false' otherwise (e.g. if it is too large)
+     */
+    bool ResultCache::insert(uint64_t key, std::string_view output, bool final) {
+        if (output.size() > MAX_ENTRY_SIZE) return false;
+
+        std::lock_guard<std::mutex> guard(mutex);
+        if (!lock(LOCK_EX)) return false;
+
+        if (scanned + entrySize(output.size()) > MAX_CACHE_SIZE) {
+            rewrite(COMPACTED_SIZE);
+            close();
+
+            if (!lock(LOCK_EX)) return false;
+        }
+
+        std::string entry;
+        entry.reserve(entrySize(output.size()));
+
+        EntryHeader header = {key, (uint32_t) output.size(), final};
+        entry.append((const char *) &header, sizeof(header));
+        entry.append(output);
+        entry.resize(entrySize(output.size()), '\0');
+
+        // the entry is written at once, so the other processes, which only read the file while it is locked, never
+        // see it partially written
+        bool written = writeAll(fd, entry.data(), entry.size());
+
+        struct stat file{};
+        if (written && !fstat(fd, &file) && map(file.st_size)) scan();
+
+        flock(fd, LOCK_UN);
+        return written;
+    }
+}
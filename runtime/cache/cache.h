@@ -0,0 +1,70 @@
+#ifndef HELPY_RUNTIME_CACHE_H
+#define HELPY_RUNTIME_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace HelpyRuntime {
+    /**
+     * @brief A persistent cache of the output of the commands marked as CACHED, which is stored in a file, so the
+     * results survive restarts.
+     *
+     * The output of a command is split into segments, one before each line of input the command reads and one after
+     * the last, each stored under the hash of the command and of the lines read before it (see hash()). Hence, a
+     * command whose input was seen before is replayed, segment by segment, without being executed.
+     *
+     * The file is append-only: it starts with a header that identifies the executable that wrote it, as the output of
+     * the commands changes when the program is rebuilt, followed by the entries. It is memory-mapped and indexed
+     * when the cache is created, and the entries appended by other processes are indexed once they are looked up. If
+     * the file grows beyond its maximum size, it is compacted, which evicts the least recently used entries.
+     *
+     * The file is stored in the home directory, unless the HELPY_CACHE environment variable points to another file.
+     */
+    class ResultCache {
+        struct Entry {
+            size_t offset; // the offset of the output in the file
+            uint32_t length;
+            bool final; // whether the output is the last segment of the command
+            uint64_t lastUse;
+        };
+
+        std::string path;
+        int fd;
+        const char *data; // the mapping of the file
+        size_t mapped, scanned; // the size of the mapping and the size of the file that is indexed
+        uint64_t build; // the identifier of the executable
+        uint64_t clock; // the number of times an entry was used
+        std::unordered_map<uint64_t, Entry> index;
+        std::mutex mutex; // the server executes commands concurrently
+
+    /* CONSTRUCTOR */
+    public:
+        explicit ResultCache(const char *name);
+        ResultCache(const ResultCache &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~ResultCache();
+
+    /* METHODS */
+    private:
+        bool open();
+        void close();
+        bool lock(int operation);
+        bool map(size_t size);
+        void scan();
+        void rewrite(size_t limit);
+
+    public:
+        static uint64_t hash(std::string_view text, uint64_t seed = 0xcbf29ce484222325);
+
+        bool find(uint64_t key, std::string &output, bool &final);
+        bool insert(uint64_t key, std::string_view output, bool final);
+    };
+}
+
+#endif //HELPY_RUNTIME_CACHE_H
@@ -0,0 +1,207 @@
+#include "compose.h"
+
+#include <cctype>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+#include "../io/io.h"
+#include "../utils/numbers.h"
+
+namespace HelpyRuntime {
+    /**
+     * @brief Verifies if a line composes several commands, i.e. if it has an operator or starts with 'repeat'.
+     * @param line the line, in lowercase
+     * @return 'true' if the line is a composition, 'false' otherwise
+     */
+    bool CommandGraph::isComposite(std::string_view line) {
+        if (line.find_first_of(";&") != std::string_view::npos) return true;
+
+        std::string_view token;
+        size_t pos = 0;
+
+        return Utils::nextToken(line, pos, token) && token == "repeat";
+    }
+
+    /**
+     * @brief Executes the command of a branch as many times as it is repeated, on the calling thread.
+     * @param branch the branch
+     * @param execute the function that executes a command
+     */
+    void CommandGraph::run(const Branch &branch, const Executor &execute) {
+        for (size_t i = 0; i < branch.repetitions; ++i)
+            execute(branch.value);
+    }
+
+    /**
+     * @brief Parses the tokens of a branch, i.e. any number of 'repeat N' followed by the words of a command.
+     * @param tokens the tokens of the line
+     * @param begin the index of the first token of the branch
+     * @param end the index after the last token of the branch
+     * @param resolve the function that resolves the words of a command
+     * @return 'true' if the branch is valid, 'false' otherwise
+     */
+    bool CommandGraph::parseBranch(const std::vector<std::string_view> &tokens, size_t begin, size_t end,
+                                   const Resolver &resolve) {
+        size_t repetitions = 1;
+
+        for (; begin < end && tokens[begin] == "repeat"; begin += 2) {
+            size_t count;
+
+            if (begin + 1 == end || !Utils::parseNumber(tokens[begin + 1], count) || !count) {
+                error_ = "'repeat' must be followed by a positive number of repetitions";
+                return false;
+            }
+
+            repetitions *= count;
+        }
+
+        if (begin == end) {
+            error_ = "Every ';' and '&' must be between two commands";
+            return false;
+        }
+
+        // the words of the command are contiguous in the line
+        const char *first = tokens[begin].data(), *last = tokens[end - 1].data() + tokens[end - 1].size();
+        std::string_view name(first, last - first);
+
+        long long value = resolve(tokens.data() + begin, end - begin);
+
+        if (!value) {
+            error_ = "'" + std::string(name) + "' is not a command";
+            return false;
+        }
+
+        branches.push_back({name, value, repetitions});
+        return true;
+    }
+
+    /**
+     * @brief Parses a line and resolves its commands. The operators need not be surrounded by spaces.
+     * @param line the line, in lowercase
+     * @param resolve the function that resolves the words of a command
+     * @return 'true' if every command of the line is valid, 'false' otherwise (see error())
+     */
+    bool CommandGraph::parse(std::string_view line, const Resolver &resolve) {
+        text = line;
+        branches.clear();
+        stageEnds.clear();
+        error_.clear();
+
+        // split the line into words and operators
+        std::vector<std::string_view> tokens;
+
+        for (size_t pos = 0; pos < text.size(); ) {
+            if (isspace((unsigned char) text[pos])) {
+                ++pos;
+                continue;
+            }
+
+            size_t start = pos;
+
+            if (text[pos] == ';' || text[pos] == '&') ++pos;
+            else {
+                while (pos < text.size() && !isspace((unsigned char) text[pos]) && text[pos] != ';' && text[pos] != '&')
+                    ++pos;
+            }
+
+            tokens.emplace_back(text.data() + start, pos - start);
+        }
+
+        size_t begin = 0;
+
+        for (size_t i = 0; i <= tokens.size(); ++i) {
+            bool last = (i == tokens.size());
+            if (!last && tokens[i] != ";" && tokens[i] != "&") continue;
+
+            if (!parseBranch(tokens, begin, i, resolve)) return false;
+            if (last || tokens[i] == ";") stageEnds.push_back(branches.size());
+
+            begin = i + 1;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Returns the error that made the line invalid.
+     * @return the error, which does not end with punctuation
+     */
+    const std::string &CommandGraph::error() const {
+        return error_;
+    }
+
+    /**
+     * @brief Returns the number of stages, which are executed one after the other.
+     * @return the number of stages
+     */
+    size_t CommandGraph::stages() const {
+        return stageEnds.size();
+    }
+
+    /**
+     * @brief Returns the branches of a stage.
+     * @param index the index of the stage
+     * @param numBranches variable which will store the number of branches
+     * @return the first branch of the stage
+     */
+    const CommandGraph::Branch *CommandGraph::stage(size_t index, size_t &numBranches) const {
+        size_t begin = index ? stageEnds[index - 1] : 0;
+        numBranches = stageEnds[index] - begin;
+
+        return branches.data() + begin;
+    }
+
+    /**
+     * @brief Executes the branches of a stage in parallel, on a pool of workers, and waits for them to finish. Their
+     * output is captured, so the buffer of the standard output must be shared (see Output::share()).
+     * @param index the index of the stage
+     * @param workers the pool of workers
+     * @param execute the function that executes a command, which must be thread-safe
+     * @return the outcome of each branch
+     */
+    std::vector<CommandGraph::Outcome> CommandGraph::runParallel(size_t index, WorkerPool &workers,
+                                                                 const Executor &execute) const {
+        size_t numBranches;
+        const Branch *first = stage(index, numBranches);
+
+        std::vector<Outcome> outcomes(numBranches);
+        size_t pending = numBranches;
+
+        std::mutex mutex;
+        std::condition_variable finished;
+
+        for (size_t i = 0; i < numBranches; ++i) {
+            workers.submit([&, i] {
+                Outcome &outcome = outcomes[i];
+
+                {
+                    IO::Capture capture(outcome.output);
+
+                    IO::Feed feed([](std::string &) -> bool {
+                        throw std::runtime_error("it reads input, which the commands that run in parallel cannot do");
+                    });
+
+                    try {
+                        run(first[i], execute);
+                    }
+                    catch (const std::exception &e) {
+                        outcome.error = e.what();
+                    }
+                    catch (...) {
+                        outcome.error = "it threw an unknown exception";
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!--pending) finished.notify_one();
+            });
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&pending] { return !pending; });
+
+        return outcomes;
+    }
+}
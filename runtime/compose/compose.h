@@ -0,0 +1,70 @@
+#ifndef HELPY_RUNTIME_COMPOSE_H
+#define HELPY_RUNTIME_COMPOSE_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../server/server.h"
+
+namespace HelpyRuntime {
+    /**
+     * @brief A line of the advanced mode that composes several commands, which is parsed and resolved once and then
+     * executed as a graph of tasks. The grammar of the line is, from the loosest to the tightest operator:
+     * - 'a ; b', which executes b after a finishes;
+     * - 'a & b', which executes a and b in parallel, on a pool of workers;
+     * - 'repeat N a', which executes a N times in a row.
+     *
+     * For instance, 'repeat 2 a & b ; c' executes a twice while b executes, and c once both finish. Hence, the graph
+     * is a sequence of stages, each of which is a set of branches that run in parallel, and each branch is a command
+     * and the number of times it is repeated.
+     *
+     * The commands that run in parallel cannot read input, and their output is captured (see IO::Capture) and
+     * displayed in the order of the line once the stage finishes, so it is not interleaved.
+     */
+    class CommandGraph {
+    public:
+        // returns the value of a command (see the executeCommand() method of the generated class), or 0 if the words
+        // are not a command
+        using Resolver = std::function<long long(const std::string_view *words, size_t numWords)>;
+
+        // executes the command with a value
+        using Executor = std::function<bool(long long value)>;
+
+        struct Branch {
+            std::string_view name; // the words of the command
+            long long value;
+            size_t repetitions;
+        };
+
+        struct Outcome {
+            std::string output;
+            std::string error; // the error that made the branch fail, if any
+        };
+
+    private:
+        std::string text; // the line, which the names of the branches are views of
+        std::vector<Branch> branches;
+        std::vector<size_t> stageEnds; // the branches of stage i are [stageEnds[i - 1], stageEnds[i])
+        std::string error_;
+
+    /* METHODS */
+    private:
+        bool parseBranch(const std::vector<std::string_view> &tokens, size_t begin, size_t end,
+                         const Resolver &resolve);
+
+    public:
+        static bool isComposite(std::string_view line);
+        static void run(const Branch &branch, const Executor &execute);
+
+        bool parse(std::string_view line, const Resolver &resolve);
+        [[nodiscard]] const std::string &error() const;
+        [[nodiscard]] size_t stages() const;
+        [[nodiscard]] const Branch *stage(size_t index, size_t &numBranches) const;
+        std::vector<Outcome> runParallel(size_t index, WorkerPool &workers, const Executor &execute) const;
+    };
+}
+
+#endif //HELPY_RUNTIME_COMPOSE_H
@@ -0,0 +1,107 @@
+#ifndef HELPY_RUNTIME_CONSOLE_H
+#define HELPY_RUNTIME_CONSOLE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../compose/compose.h"
+#include "../editor/editor.h"
+#include "../jobs/jobs.h"
+#include "../plugin/plugin.h"
+#include "../replay/replay.h"
+#include "../server/server.h"
+
+namespace HelpyRuntime {
+    class InputSession;
+    class ResultCache;
+
+    namespace IO {
+        class Feed;
+    }
+
+    /**
+     * @brief The base class of every generated Helpy class, which implements the methods used to read user input.
+     */
+    class Console {
+        const char *color;
+        mutable std::string line; // the buffer of the last line read, which is reused to avoid allocations
+        CommandTrie commands;
+        mutable Editor editor;
+        mutable std::string suggestion; // the buffer of the last suggestion of a command
+        JobPool jobs; // the commands that run in the background
+        std::unique_ptr<WorkerPool> workers; // the pool that runs the commands composed in parallel (see CommandGraph)
+        bool sharing; // whether the buffer of the standard output is shared for the jobs (see Output::share())
+
+        friend class HelpyRuntime::InputSession; // reads the input of the commands that are coroutines
+
+    /* CONSTRUCTOR */
+    protected:
+        explicit Console(const char *color, CommandTrie commands = {}, const char *name = nullptr);
+
+    /* METHODS */
+    private:
+        const std::string &readLine(std::string_view instruction, std::string_view suffix = "", bool command = false) const;
+        const std::string &readRawLine(IO::Feed *feed, bool command = false) const;
+
+        template <typename T>
+        T readValue(std::string_view instruction, int base) const;
+
+        template <typename T>
+        T readValue(std::string_view instruction, T minimum, T maximum, int base) const;
+
+        void printError(std::string_view message) const;
+        void *resolvePlugin(PluginTable &plugins, size_t command) const;
+        void printJob(const JobPool::Job &job) const;
+
+    protected:
+        [[nodiscard]] bool colorsEnabled() const;
+        [[nodiscard]] static bool interactive();
+        static void flush();
+
+        std::string readInput(std::string_view instruction, bool caseSensitive = false) const;
+        std::string readInput(std::string_view instruction, const std::vector<std::string> &options) const;
+        bool readYesOrNo(std::string_view instruction, bool strict = false) const;
+        size_t readCommand(std::string_view instruction, std::string_view *words, size_t maxWords) const;
+        std::string_view suggestCommand(const std::string_view *words, size_t numWords) const;
+        JobPool::Handle submitJob(std::string_view name, std::function<void(const StopToken &)> task);
+        bool runJobCommand(const std::string_view *words, size_t numWords);
+        void reportJobs();
+        void finishJobs();
+        int serve(const char *path, unsigned numWorkers, Server::Handler handler);
+        static int recordSession(const char *path, const std::function<void()> &console);
+        static int replaySessions(const char *path, unsigned numWorkers, const std::function<void()> &console);
+        size_t benchmark(const std::function<bool()> &command, size_t iterations) const;
+        void runCached(ResultCache &cache, std::string_view name, const std::function<void()> &command) const;
+        bool runComposite(const CommandGraph::Resolver &resolve, const CommandGraph::Executor &execute);
+        void reloadPlugins(PluginTable &plugins) const;
+
+        /**
+         * @brief Returns the entry point of a command that is built as a plugin (see resolvePlugin()).
+         * @param plugins the dispatch table of the plugins
+         * @param command the index of the command
+         * @return the entry point, or nullptr if it could not be loaded
+         */
+        template <typename F>
+        F loadPlugin(PluginTable &plugins, size_t command) const {
+            return reinterpret_cast<F>(resolvePlugin(plugins, command));
+        }
+        double readNumber(std::string_view instruction) const;
+        double readNumber(std::string_view instruction, double minimum, double maximum) const;
+        double readNumber(std::string_view instruction, const std::vector<double> &options) const;
+        long long readInteger(std::string_view instruction) const;
+        long long readInteger(std::string_view instruction, long long minimum, long long maximum) const;
+        unsigned long long readUnsigned(std::string_view instruction) const;
+        unsigned long long readUnsigned(std::string_view instruction, unsigned long long minimum,
+                                        unsigned long long maximum) const;
+        unsigned long long readHex(std::string_view instruction) const;
+        unsigned long long readHex(std::string_view instruction, unsigned long long minimum,
+                                   unsigned long long maximum) const;
+        std::vector<double> readNumbers(std::string_view instruction) const;
+        std::string readFilename(std::string_view instruction) const;
+        std::string readDirname(std::string_view instruction) const;
+        std::vector<std::string> readCSV(std::string_view instruction, char delimiter = ',') const;
+    };
+}
+
+#endif //HELPY_RUNTIME_CONSOLE_H
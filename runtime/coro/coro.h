@@ -0,0 +1,564 @@
+#ifndef HELPY_RUNTIME_CORO_H
+#define HELPY_RUNTIME_CORO_H
+
+/*
+ * The coroutine versions of the input methods of the consoles, which require C++20. The rest of the runtime is
+ * C++17, so this header is empty unless the program that includes it is compiled with coroutine support.
+ */
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../io/io.h"
+#include "../utils/numbers.h"
+#include "../utils/strings.h"
+
+namespace HelpyRuntime {
+    template <typename T = void>
+    class Task;
+
+    /**
+     * @brief The part of the promise of a Task that does not depend on its result. When a task finishes, the
+     * coroutine that awaits it is resumed right away (symmetric transfer), so a chain of tasks does not grow the
+     * stack.
+     */
+    struct TaskPromiseBase {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+
+        struct FinalAwaiter {
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
+            }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+                std::coroutine_handle<> continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        [[nodiscard]] std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        [[nodiscard]] FinalAwaiter final_suspend() const noexcept {
+            return {};
+        }
+
+        void unhandled_exception() noexcept {
+            exception = std::current_exception();
+        }
+    };
+
+    template <typename T>
+    struct TaskPromise : TaskPromiseBase {
+        std::optional<T> result;
+
+        void return_value(T value) {
+            result.emplace(std::move(value));
+        }
+    };
+
+    template <>
+    struct TaskPromise<void> : TaskPromiseBase {
+        void return_void() const noexcept {}
+    };
+
+    /**
+     * @brief A coroutine that produces a value of type T. It only starts when it is awaited (co_await), or when it
+     * is run by an InputSession or a SessionLoop, and it is destroyed along with the task.
+     */
+    template <typename T>
+    class Task {
+    public:
+        struct promise_type : TaskPromise<T> {
+            Task get_return_object() {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+
+    /* CONSTRUCTOR */
+    private:
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    public:
+        Task() = default;
+        Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+        Task &operator=(Task &&other) noexcept {
+            if (this != &other) {
+                if (handle) handle.destroy();
+                handle = std::exchange(other.handle, nullptr);
+            }
+
+            return *this;
+        }
+
+    /* DESTRUCTOR */
+    public:
+        ~Task() {
+            if (handle) handle.destroy();
+        }
+
+    /* METHODS */
+    public:
+        /**
+         * @brief Verifies if the coroutine finished, either by returning or by throwing an exception.
+         * @return 'true' if the coroutine finished, 'false' if it did not start or is suspended
+         */
+        [[nodiscard]] bool done() const {
+            return !handle || handle.done();
+        }
+
+        /**
+         * @brief Starts the coroutine, which runs until it finishes or waits for input.
+         */
+        void start() const {
+            handle.resume();
+        }
+
+        /**
+         * @brief Returns the result of the coroutine, which must have finished.
+         * @return the value the coroutine returned
+         * @throws the exception the coroutine threw, if it did
+         */
+        T get() {
+            if (handle.promise().exception)
+                std::rethrow_exception(handle.promise().exception);
+
+            if constexpr (!std::is_void_v<T>)
+                return std::move(*handle.promise().result);
+        }
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) const noexcept {
+            handle.promise().continuation = caller;
+            return handle;
+        }
+
+        T await_resume() {
+            return get();
+        }
+    };
+
+    /**
+     * @brief The input of a session, which the commands read with the coroutine versions of the input methods of the
+     * consoles (e.g. co_await input.readInteger("Enter a number")).
+     *
+     * An input session works in one of two ways:
+     * - if it is created from a console, it is blocking, i.e. the input is read by the console as usual and the
+     * coroutines never suspend, so the commands also work in the guided and advanced modes;
+     * - otherwise, the coroutines suspend whenever they need a line that was not received yet, and are resumed by
+     * the SessionLoop that runs the session once it is. The prompts and messages are written to the output of the
+     * session, instead of the console.
+     *
+     * A suspended session takes little more memory than the frames of its coroutines, so a single thread can
+     * multiplex a large number of sessions that wait for input.
+     */
+    class InputSession {
+        friend class SessionLoop;
+
+        // the console that reads the input, if the session is blocking
+        const void *console = nullptr;
+        const std::string &(*readBlocking)(const void *, std::string_view, std::string_view) = nullptr;
+        void (*printBlocking)(const void *, std::string_view) = nullptr;
+
+        std::vector<std::string> lines; // the lines that were received but not read
+        size_t next = 0; // the index of the next line to be read
+        bool ended = false; // whether no more lines will be received
+        std::string line; // the buffer of the last line read
+        const std::string *last = nullptr; // the last line read, or nullptr if the input ended
+        std::coroutine_handle<> waiting; // the coroutine that waits for a line
+
+        std::string output;
+
+    public:
+        /**
+         * @brief Displays an instruction and waits for a line of input. Leading whitespace and blank lines are
+         * skipped.
+         */
+        class LineAwaiter {
+            InputSession &session;
+            std::string_view instruction, suffix;
+
+        public:
+            LineAwaiter(InputSession &session, std::string_view instruction, std::string_view suffix)
+                : session(session), instruction(instruction), suffix(suffix) {}
+
+            bool await_ready() {
+                if (session.console) {
+                    session.last = &session.readBlocking(session.console, instruction, suffix);
+                    return true;
+                }
+
+                ((session.output += instruction) += suffix) += '\n';
+                return session.pop();
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) {
+                session.waiting = handle;
+            }
+
+            /**
+             * @return the line that was read, which is valid until the next line is read
+             * @throws std::runtime_error if the input ended, since the line will never come
+             */
+            const std::string &await_resume() const {
+                if (!session.last)
+                    throw std::runtime_error("the input ended");
+
+                return *session.last;
+            }
+        };
+
+    /* CONSTRUCTOR */
+    public:
+        InputSession() = default;
+
+        /**
+         * @brief Creates a blocking session, whose input is read by a console (i.e. the generated class).
+         * @param console the console
+         */
+        template <typename Console>
+        explicit InputSession(const Console &console) : console(&console) {
+            readBlocking = [](const void *console_, std::string_view instruction,
+                              std::string_view suffix) -> const std::string & {
+                return static_cast<const Console *>(console_)->readLine(instruction, suffix);
+            };
+
+            printBlocking = [](const void *console_, std::string_view message) {
+                static_cast<const Console *>(console_)->printError(message);
+            };
+        }
+
+        InputSession(const InputSession &) = delete;
+
+    /* METHODS */
+    private:
+        /**
+         * @brief Reads the next line that was received and is not blank, if there is one.
+         * @return 'true' if a line was read or the input ended, 'false' if the session must wait for a line
+         */
+        bool pop() {
+            for (; next < lines.size(); ++next) {
+                std::string &received = lines[next];
+                received.erase(0, received.find_first_not_of(" \t"));
+
+                if (received.empty()) continue;
+
+                line = std::move(received);
+                last = &line;
+
+                // release the lines that were read, once every one was
+                if (++next == lines.size()) {
+                    lines.clear();
+                    next = 0;
+                }
+
+                return true;
+            }
+
+            last = nullptr;
+            return ended;
+        }
+
+        /**
+         * @brief Displays an error message, e.g. because the input is invalid.
+         * @param message the message
+         */
+        void printError(std::string_view message) {
+            if (console) printBlocking(console, message);
+            else (output += message) += '\n';
+        }
+
+        template <typename T>
+        Task<T> readValue(std::string_view instruction, int base) {
+            T number;
+
+            while (!Utils::parseFirstNumber(co_await readLine(instruction), number, base))
+                printError("Invalid input! Please, try again.");
+
+            co_return number;
+        }
+
+        template <typename T>
+        Task<T> readValue(std::string_view instruction, T minimum, T maximum, int base) {
+            for (;;) {
+                T number = co_await readValue<T>(instruction, base);
+
+                // verify if the number is within the specified range
+                if (number >= minimum && number <= maximum)
+                    co_return number;
+
+                printError("Invalid number! Please, try again.");
+            }
+        }
+
+    public:
+        /**
+         * @brief Runs a command of a blocking session to completion.
+         * @param task the coroutine of the command
+         * @throws the exception the command threw, if it did
+         */
+        void run(Task<> task) {
+            task.start();
+
+            if (!task.done())
+                throw std::logic_error("only blocking sessions can be run without a SessionLoop");
+
+            task.get();
+        }
+
+        /**
+         * @brief Returns the output of the session (the prompts and messages it displayed and, if it is run by a
+         * SessionLoop, everything its commands wrote) since it was last emptied.
+         * @return the output
+         */
+        std::string &getOutput() {
+            return output;
+        }
+
+        /**
+         * @brief Reads a line of input. The instruction (and the suffix) must outlive the coroutine that awaits it.
+         * @param instruction the instruction that will be displayed before waiting for input
+         * @param suffix text that is displayed right after the instruction
+         * @return the awaiter, which results in the line that was read
+         */
+        LineAwaiter readLine(std::string_view instruction, std::string_view suffix = "") {
+            return {*this, instruction, suffix};
+        }
+
+        /**
+         * @brief Reads a line of input.
+         * @param instruction the instruction that will be displayed before waiting for input
+         * @param caseSensitive boolean indicating whether the input should be treated as case-sensitive
+         * @return the line that was read
+         */
+        Task<std::string> readInput(std::string_view instruction, bool caseSensitive = false) {
+            std::string input = co_await readLine(instruction);
+
+            // if the input is NOT case-sensitive, convert it to lowercase
+            if (!caseSensitive)
+                Utils::toLowercase(input);
+
+            co_return input;
+        }
+
+        /**
+         * @brief Reads input until one of its words is one of the options.
+         * @param instruction the instruction that will be displayed before waiting for input
+         * @param options the options, in lowercase, which must outlive the coroutine
+         * @return the first word input that is an option
+         */
+        Task<std::string> readInput(std::string_view instruction, const std::vector<std::string> &options) {
+            std::unordered_set<std::string_view> options_(options.begin(), options.end());
+
+            for (;;) {
+                std::string input = co_await readInput(instruction);
+                std::string_view word;
+
+                for (size_t pos = 0; Utils::nextToken(input, pos, word); ) {
+                    if (options_.find(word) != options_.end())
+                        co_return std::string(word);
+                }
+
+                printError("Invalid command! Please, try again.");
+            }
+        }
+
+        /**
+         * @brief Reads the answer to a Yes/No question.
+         * @param instruction the instruction that will be displayed before waiting for input
+         * @return 'true' if the answer was Yes, 'false' otherwise
+         */
+        Task<bool> readYesOrNo(std::string_view instruction) {
+            std::string answer = co_await readLine(instruction, " (Yes/No)");
+            Utils::toLowercase(answer);
+
+            co_return answer == "yes" || answer == "y";
+        }
+
+        Task<double> readNumber(std::string_view instruction) {
+            return readValue<double>(instruction, 10);
+        }
+
+        Task<double> readNumber(std::string_view instruction, double minimum, double maximum) {
+            return readValue<double>(instruction, minimum, maximum, 10);
+        }
+
+        Task<long long> readInteger(std::string_view instruction) {
+            return readValue<long long>(instruction, 10);
+        }
+
+        Task<long long> readInteger(std::string_view instruction, long long minimum, long long maximum) {
+            return readValue<long long>(instruction, minimum, maximum, 10);
+        }
+
+        Task<unsigned long long> readUnsigned(std::string_view instruction) {
+            return readValue<unsigned long long>(instruction, 10);
+        }
+
+        Task<unsigned long long> readUnsigned(std::string_view instruction, unsigned long long minimum,
+                                              unsigned long long maximum) {
+            return readValue<unsigned long long>(instruction, minimum, maximum, 10);
+        }
+    };
+
+    /**
+     * @brief Multiplexes many sessions on the calling thread. Each session runs a command, which is resumed whenever
+     * the line it waits for is received (see feed()), until it finishes.
+     *
+     * While a command runs, its output is captured into the output of its session (see IO::Capture). With the
+     * iostream backend, std::cout is only captured while the output is shared (see Output::share()).
+     */
+    class SessionLoop {
+        struct Entry {
+            InputSession session;
+            Task<> task;
+        };
+
+        std::vector<std::unique_ptr<Entry>> entries; // indexed by the id of the session
+        size_t numActive = 0;
+
+    /* METHODS */
+    private:
+        /**
+         * @brief Resumes the command of a session until it finishes or waits for input again.
+         * @param entry the session
+         * @param handle the coroutine that is resumed, or nullptr to start the command
+         */
+        void resume(Entry &entry, std::coroutine_handle<> handle) {
+            {
+                IO::Capture capture(entry.session.output);
+
+                if (handle) handle.resume();
+                else entry.task.start();
+            }
+
+            if (!entry.task.done()) return;
+
+            --numActive;
+
+            try {
+                entry.task.get();
+            }
+            catch (const std::exception &e) {
+                ((entry.session.output += "Error: ") += e.what()) += '\n';
+            }
+        }
+
+        /**
+         * @brief Resumes the command of a session, if the line it waits for was received.
+         * @param entry the session
+         */
+        void wake(Entry &entry) {
+            InputSession &session = entry.session;
+            if (session.waiting && session.pop()) resume(entry, std::exchange(session.waiting, nullptr));
+        }
+
+    public:
+        /**
+         * @brief Starts a session, whose command runs until it waits for input.
+         * @param command a function that receives the input session and returns the coroutine of the command
+         * @return the id of the session
+         */
+        template <typename Command>
+        size_t start(Command &&command) {
+            Entry &entry = *entries.emplace_back(std::make_unique<Entry>());
+
+            entry.task = command(entry.session);
+            ++numActive;
+
+            resume(entry, std::coroutine_handle<>());
+            return entries.size() - 1;
+        }
+
+        /**
+         * @brief Delivers a line of input to a session.
+         * @param id the id of the session
+         * @param line the line
+         * @return 'true' if the session exists and its command is running, 'false' otherwise
+         */
+        bool feed(size_t id, std::string line) {
+            if (finished(id)) return false;
+
+            Entry &entry = *entries[id];
+            entry.session.lines.push_back(std::move(line));
+            wake(entry);
+
+            return true;
+        }
+
+        /**
+         * @brief Signals that a session will receive no more input, so a command that waits for it fails.
+         * @param id the id of the session
+         */
+        void close(size_t id) {
+            if (finished(id)) return;
+
+            Entry &entry = *entries[id];
+            entry.session.ended = true;
+            wake(entry);
+        }
+
+        /**
+         * @brief Verifies if the command of a session finished.
+         * @param id the id of the session
+         * @return 'true' if the command finished or the session does not exist, 'false' otherwise
+         */
+        [[nodiscard]] bool finished(size_t id) const {
+            return id >= entries.size() || !entries[id] || entries[id]->task.done();
+        }
+
+        /**
+         * @brief Takes the output of a session, i.e. returns it and empties it.
+         * @param id the id of the session
+         * @return the output
+         */
+        std::string takeOutput(size_t id) {
+            if (id >= entries.size() || !entries[id]) return {};
+            return std::exchange(entries[id]->session.output, {});
+        }
+
+        /**
+         * @brief Destroys a session and its command, even if it did not finish.
+         * @param id the id of the session
+         */
+        void remove(size_t id) {
+            if (id >= entries.size() || !entries[id]) return;
+
+            if (!entries[id]->task.done()) --numActive;
+            entries[id].reset();
+        }
+
+        /**
+         * @brief Returns the number of sessions whose commands are running.
+         * @return the number of sessions
+         */
+        [[nodiscard]] size_t size() const {
+            return numActive;
+        }
+    };
+}
+
+#endif
+
+#endif //HELPY_RUNTIME_CORO_H
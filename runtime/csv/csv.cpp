@@ -0,0 +1,427 @@
+#include "csv.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// the minimum size of each of the chunks that are parsed in parallel
+#define CHUNK_SIZE (16 << 20)
+
+// the size of the sample which is used to estimate the number of fields of a chunk
+#define SAMPLE_SIZE (64 << 10)
+
+namespace HelpyRuntime {
+    /**
+     * @brief The positions of the special characters of a block of 64 bytes, as bit masks (bit i is set if the
+     * i-th byte is the character).
+     */
+    struct Masks {
+        uint64_t quotes, delimiters, newlines;
+    };
+
+    /**
+     * @brief The fields and rows of a chunk of a CSV file.
+     */
+    struct Chunk {
+        std::vector<std::string_view> fields;
+        std::vector<size_t> rowStarts;
+        std::deque<std::string> unescaped;
+    };
+
+#if defined(__AVX2__)
+    /**
+     * @brief Finds the positions of a character in a block of 32 bytes.
+     * @param block the block
+     * @param c the character
+     * @return the bit mask of the positions of the character
+     */
+    static inline uint64_t match(__m256i block, char c) {
+        return (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(c)));
+    }
+
+    /**
+     * @brief Finds the special characters of a block of 64 bytes.
+     * @param data the block
+     * @param delimiter the character that separates the fields
+     * @return the masks of the special characters
+     */
+    static inline Masks findMasks(const char *data, char delimiter) {
+        __m256i lo = _mm256_loadu_si256((const __m256i *) data);
+        __m256i hi = _mm256_loadu_si256((const __m256i *) (data + 32));
+
+        return {
+            match(lo, '"') | match(hi, '"') << 32,
+            match(lo, delimiter) | match(hi, delimiter) << 32,
+            match(lo, '\n') | match(hi, '\n') << 32
+        };
+    }
+#elif defined(__SSE2__)
+    /**
+     * @brief Finds the positions of a character in a block of 64 bytes.
+     * @param blocks the block, as four vectors of 16 bytes
+     * @param c the character
+     * @return the bit mask of the positions of the character
+     */
+    static inline uint64_t match(const __m128i *blocks, char c) {
+        __m128i c_ = _mm_set1_epi8(c);
+        uint64_t mask = 0;
+
+        for (int i = 0; i < 4; ++i)
+            mask |= (uint64_t) (uint16_t) _mm_movemask_epi8(_mm_cmpeq_epi8(blocks[i], c_)) << (16 * i);
+
+        return mask;
+    }
+
+    /**
+     * @brief Finds the special characters of a block of 64 bytes.
+     * @param data the block
+     * @param delimiter the character that separates the fields
+     * @return the masks of the special characters
+     */
+    static inline Masks findMasks(const char *data, char delimiter) {
+        __m128i blocks[4];
+
+        for (int i = 0; i < 4; ++i)
+            blocks[i] = _mm_loadu_si128((const __m128i *) (data + 16 * i));
+
+        return {match(blocks, '"'), match(blocks, delimiter), match(blocks, '\n')};
+    }
+#else
+    /**
+     * @brief Finds the special characters of a block of 64 bytes.
+     * @param data the block
+     * @param delimiter the character that separates the fields
+     * @return the masks of the special characters
+     */
+    static inline Masks findMasks(const char *data, char delimiter) {
+        Masks masks{};
+
+        for (int i = 0; i < 64; ++i) {
+            masks.quotes |= (uint64_t) (data[i] == '"') << i;
+            masks.delimiters |= (uint64_t) (data[i] == delimiter) << i;
+            masks.newlines |= (uint64_t) (data[i] == '\n') << i;
+        }
+
+        return masks;
+    }
+#endif
+
+    /**
+     * @brief Finds the special characters of a block of (up to) 64 bytes, which may be the incomplete last block.
+     * @param data the start of the block
+     * @param end the end of the data
+     * @param delimiter the character that separates the fields
+     * @return the masks of the special characters
+     */
+    static inline Masks findMasks(const char *data, const char *end, char delimiter) {
+        if (end - data >= 64) return findMasks(data, delimiter);
+
+        // pad the last block with characters that are not special
+        char block[64];
+        std::memset(block, delimiter ? 0 : ' ', sizeof(block));
+        std::memcpy(block, data, end - data);
+
+        return findMasks(block, delimiter);
+    }
+
+    /**
+     * @brief Computes the prefix XOR of a mask, in which bit i is set if there is an odd number of set bits in
+     * positions [0, i] of the mask. Applied to the quotation marks, it yields the bytes that are within quotes.
+     * @param mask the mask
+     * @return the prefix XOR of the mask
+     */
+    static inline uint64_t prefixXor(uint64_t mask) {
+        mask ^= mask << 1;
+        mask ^= mask << 2;
+        mask ^= mask << 4;
+        mask ^= mask << 8;
+        mask ^= mask << 16;
+        mask ^= mask << 32;
+
+        return mask;
+    }
+
+    /**
+     * @brief Counts the quotation marks of a piece of data.
+     * @param data the start of the data
+     * @param end the end of the data
+     * @return the number of quotation marks
+     */
+    static size_t countQuotes(const char *data, const char *end) {
+        size_t count = 0;
+
+        for (; data < end; data += 64)
+            count += __builtin_popcountll(findMasks(data, end, ',').quotes);
+
+        return count;
+    }
+
+    /**
+     * @brief Parses the rows of a piece of a CSV file, which must start at the beginning of a row.
+     * @param data the start of the piece
+     * @param end the end of the piece
+     * @param delimiter the character that separates the fields
+     * @param chunk the chunk which will store the fields and rows
+     */
+    static void parseChunk(const char *data, const char *end, char delimiter, Chunk &chunk) {
+        const char *fieldStart = data;
+        uint64_t inside = 0; // all ones if the previous block ended inside quotes
+
+        chunk.rowStarts.push_back(0);
+
+        // estimate the number of fields from the first blocks, to avoid growing the vectors repeatedly
+        const char *sampleEnd = data + std::min<size_t>(end - data, SAMPLE_SIZE);
+        size_t numSeparators = 1, numNewlines = 1;
+
+        for (const char *block = data; block < sampleEnd; block += 64) {
+            Masks masks = findMasks(block, sampleEnd, delimiter);
+
+            numSeparators += __builtin_popcountll(masks.delimiters | masks.newlines);
+            numNewlines += __builtin_popcountll(masks.newlines);
+        }
+
+        double ratio = (double) (end - data) / (double) (sampleEnd - data + 1);
+        chunk.fields.reserve((size_t) ((double) numSeparators * ratio * 1.1));
+        chunk.rowStarts.reserve((size_t) ((double) numNewlines * ratio * 1.1));
+
+        auto addField = [&](const char *fieldEnd, bool endOfRow) {
+            if (endOfRow && fieldEnd > fieldStart && fieldEnd[-1] == '\r') --fieldEnd;
+            std::string_view field(fieldStart, fieldEnd - fieldStart);
+
+            size_t rowSize = chunk.fields.size() - chunk.rowStarts.back();
+            bool blankLine = endOfRow && !rowSize && field.empty();
+
+            fieldStart = fieldEnd + 1 + (endOfRow && fieldEnd < end && *fieldEnd == '\r');
+            if (blankLine) return;
+
+            // remove the quotation marks
+            if (!field.empty() && field.front() == '"') {
+                field.remove_prefix(1);
+                if (!field.empty() && field.back() == '"') field.remove_suffix(1);
+
+                // unescape the quotation marks ("" -> ")
+                if (std::memchr(field.data(), '"', field.size())) {
+                    std::string &unescaped = chunk.unescaped.emplace_back();
+
+                    for (size_t i = 0; i < field.size(); ++i) {
+                        unescaped += field[i];
+                        if (field[i] == '"' && i + 1 < field.size() && field[i + 1] == '"') ++i;
+                    }
+
+                    field = unescaped;
+                }
+            }
+
+            chunk.fields.push_back(field);
+            if (endOfRow) chunk.rowStarts.push_back(chunk.fields.size());
+        };
+
+        for (const char *block = data; block < end; block += 64) {
+            Masks masks = findMasks(block, end, delimiter);
+
+            uint64_t quoted = prefixXor(masks.quotes) ^ inside;
+            inside = (uint64_t) ((int64_t) quoted >> 63);
+
+            // the separators that are not within quotes
+            uint64_t separators = (masks.delimiters | masks.newlines) & ~quoted;
+
+            while (separators) {
+                int i = __builtin_ctzll(separators);
+                addField(block + i, (masks.newlines >> i) & 1);
+
+                separators &= separators - 1;
+            }
+        }
+
+        // the last row, which lacks a line break
+        if (fieldStart < end || chunk.fields.size() > chunk.rowStarts.back())
+            addField(end, true);
+    }
+
+    /**
+     * @brief Opens and parses a CSV file.
+     * @param path the path to the file
+     * @param delimiter the character that separates the fields
+     * @param hasHeader boolean indicating if the first row contains the names of the columns
+     */
+    CSV::CSV(const char *path, char delimiter, bool hasHeader)
+        : fd(open(path, O_RDONLY)), data(nullptr), size(0), delimiter(delimiter), hasHeader(hasHeader) {
+        rowStarts.push_back(0);
+        if (fd < 0) return;
+
+        struct stat info{};
+
+        if (!fstat(fd, &info) && info.st_size > 0) {
+            void *map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (map != MAP_FAILED) {
+                madvise(map, info.st_size, MADV_SEQUENTIAL);
+
+                data = (const char *) map;
+                size = info.st_size;
+            }
+        }
+
+        parse();
+    }
+
+    /**
+     * @brief Unmaps and closes the file.
+     */
+    CSV::~CSV() {
+        if (data) munmap((void *) data, size);
+        if (fd >= 0) close(fd);
+    }
+
+    /**
+     * @brief Parses the file. Files that are larger than CHUNK_SIZE are split into chunks that are parsed in
+     * parallel.
+     *
+     * Since quoted fields may contain line breaks, the chunks cannot be split at any line break. Instead, the
+     * quotation marks of each chunk are counted first (in parallel), which determines whether each chunk starts
+     * within quotes, so that its first row can be found.
+     */
+    void CSV::parse() {
+        size_t numChunks = std::clamp<size_t>(size / CHUNK_SIZE, 1, std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<Chunk> chunks(numChunks);
+
+        if (numChunks == 1)
+            parseChunk(data, data + size, delimiter, chunks[0]);
+        else {
+            std::vector<size_t> starts(numChunks + 1), quotes(numChunks);
+            std::vector<std::thread> threads;
+
+            for (size_t i = 0; i <= numChunks; ++i)
+                starts[i] = size / numChunks * i;
+
+            starts[numChunks] = size;
+
+            // count the quotation marks of each chunk
+            for (size_t i = 0; i < numChunks; ++i)
+                threads.emplace_back([&, i] { quotes[i] = countQuotes(data + starts[i], data + starts[i + 1]); });
+
+            for (std::thread &thread : threads)
+                thread.join();
+
+            threads.clear();
+
+            // move the start of each chunk to the start of its first row
+            bool inside = false;
+
+            for (size_t i = 1; i < numChunks; ++i) {
+                inside ^= quotes[i - 1] & 1;
+
+                size_t pos = starts[i];
+                bool inside_ = inside;
+
+                for (; pos < size && (data[pos] != '\n' || inside_); ++pos)
+                    inside_ ^= data[pos] == '"';
+
+                starts[i] = std::max(std::min(pos + 1, size), starts[i - 1]);
+            }
+
+            for (size_t i = 0; i < numChunks; ++i) {
+                threads.emplace_back([&, i] {
+                    parseChunk(data + starts[i], data + starts[i + 1], delimiter, chunks[i]);
+                });
+            }
+
+            for (std::thread &thread : threads)
+                thread.join();
+        }
+
+        if (numChunks == 1) {
+            fields = std::move(chunks[0].fields);
+            rowStarts = std::move(chunks[0].rowStarts);
+            unescaped.push_back(std::move(chunks[0].unescaped));
+
+            return;
+        }
+
+        // merge the chunks
+        size_t numFields = 0, numRows = 0;
+
+        for (const Chunk &chunk : chunks) {
+            numFields += chunk.fields.size();
+            numRows += chunk.rowStarts.size() - 1;
+        }
+
+        fields.reserve(numFields);
+        rowStarts.reserve(numRows + 1);
+        unescaped.reserve(numChunks);
+
+        for (Chunk &chunk : chunks) {
+            size_t offset = fields.size();
+            fields.insert(fields.end(), chunk.fields.begin(), chunk.fields.end());
+
+            for (size_t i = 1; i < chunk.rowStarts.size(); ++i)
+                rowStarts.push_back(offset + chunk.rowStarts[i]);
+
+            // moving the strings would invalidate the views of short strings, so the whole deque is moved instead
+            unescaped.push_back(std::move(chunk.unescaped));
+        }
+    }
+
+    /**
+     * @brief Parses a single line of CSV (e.g. a line of user input).
+     * @param line the line
+     * @param delimiter the character that separates the fields
+     * @return the fields of the line
+     */
+    std::vector<std::string> CSV::parseLine(std::string_view line, char delimiter) {
+        Chunk chunk;
+        parseChunk(line.data(), line.data() + line.size(), delimiter, chunk);
+
+        return {chunk.fields.begin(), chunk.fields.end()};
+    }
+
+    /**
+     * @brief Verifies if the file was successfully opened.
+     * @return 'true' if the file is open, 'false' otherwise
+     */
+    bool CSV::isOpen() const {
+        return fd >= 0;
+    }
+
+    /**
+     * @brief Returns the number of rows of the file, excluding the header.
+     * @return the number of rows
+     */
+    size_t CSV::numRows() const {
+        size_t numRows = rowStarts.size() - 1;
+        return (hasHeader && numRows) ? numRows - 1 : numRows;
+    }
+
+    /**
+     * @brief Returns the header of the file, which contains the names of the columns.
+     * @return the header, which is empty if the file has no header
+     */
+    CSV::Row CSV::header() const {
+        if (!hasHeader || rowStarts.size() < 2) return {nullptr, 0};
+        return {fields.data(), rowStarts[1]};
+    }
+
+    /**
+     * @brief Finds a column by its name.
+     * @param name the name of the column
+     * @return the index of the column, or std::string_view::npos if there is no such column
+     */
+    size_t CSV::columnIndex(std::string_view name) const {
+        Row header_ = header();
+
+        for (size_t i = 0; i < header_.size(); ++i) {
+            if (header_[i] == name) return i;
+        }
+
+        return std::string_view::npos;
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef HELPY_RUNTIME_CSV_H
+#define HELPY_RUNTIME_CSV_H
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "../utils/numbers.h"
+
+namespace HelpyRuntime {
+    /**
+     * @brief A CSV file, parsed according to RFC 4180 (i.e. fields may be enclosed in quotation marks, in which case
+     * they may contain delimiters, line breaks and escaped quotation marks).
+     *
+     * The file is mapped into memory and the fields are views of the mapping, so they are only copied if they
+     * contain escaped quotation marks. The delimiters, quotation marks and line breaks are found with SIMD
+     * instructions, 64 bytes at a time, and large files are split into chunks that are parsed in parallel.
+     */
+    class CSV {
+        int fd;
+        const char *data;
+        size_t size;
+
+        char delimiter;
+        bool hasHeader;
+
+        std::vector<std::string_view> fields;
+        std::vector<size_t> rowStarts; // the index of the first field of each row, followed by the number of fields
+        std::vector<std::deque<std::string>> unescaped; // the fields which contained escaped quotation marks
+
+    public:
+        /**
+         * @brief A row of a CSV file.
+         */
+        class Row {
+            const std::string_view *fields;
+            size_t numFields;
+
+        public:
+            Row(const std::string_view *fields, size_t numFields) : fields(fields), numFields(numFields) {}
+
+            [[nodiscard]] size_t size() const {
+                return numFields;
+            }
+
+            /**
+             * @brief Returns a field of the row.
+             * @param column the index of the column of the field
+             * @return the field, or an empty view if the row does not have that many fields
+             */
+            std::string_view operator[](size_t column) const {
+                return (column < numFields) ? fields[column] : std::string_view();
+            }
+
+            [[nodiscard]] const std::string_view *begin() const {
+                return fields;
+            }
+
+            [[nodiscard]] const std::string_view *end() const {
+                return fields + numFields;
+            }
+        };
+
+    /* CONSTRUCTOR */
+    public:
+        explicit CSV(const char *path, char delimiter = ',', bool hasHeader = true);
+        CSV(const CSV &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~CSV();
+
+    /* METHODS */
+    private:
+        void parse();
+
+    public:
+        static std::vector<std::string> parseLine(std::string_view line, char delimiter = ',');
+
+        [[nodiscard]] bool isOpen() const;
+        [[nodiscard]] size_t numRows() const;
+        [[nodiscard]] Row header() const;
+        [[nodiscard]] size_t columnIndex(std::string_view name) const;
+
+        /**
+         * @brief Returns a row of the file. The header, if any, is not considered a row.
+         * @param row the index of the row
+         * @return the row
+         */
+        Row operator[](size_t row) const {
+            row += hasHeader;
+            return {fields.data() + rowStarts[row], rowStarts[row + 1] - rowStarts[row]};
+        }
+
+        /**
+         * @brief Returns the values of a column, converted to the specified type. Numbers are parsed with
+         * Utils::parseNumber, and fields that are missing or are not numbers are converted to 0.
+         * @param column the index of the column
+         * @return the values of the column
+         */
+        template <typename T>
+        std::vector<T> column(size_t column) const {
+            std::vector<T> values(numRows());
+
+            for (size_t i = 0; i < values.size(); ++i) {
+                std::string_view field = (*this)[i][column];
+
+                if constexpr (std::is_arithmetic_v<T>) {
+                    values[i] = T();
+                    Utils::parseNumber(field, values[i]);
+                }
+                else
+                    values[i] = T(field);
+            }
+
+            return values;
+        }
+
+        /**
+         * @brief Returns the values of a column, converted to the specified type.
+         * @param name the name of the column, as specified in the header
+         * @return the values of the column, or an empty vector if there is no such column
+         */
+        template <typename T>
+        std::vector<T> column(std::string_view name) const {
+            size_t index = columnIndex(name);
+            return (index == std::string_view::npos) ? std::vector<T>() : column<T>(index);
+        }
+    };
+}
+
+#endif //HELPY_RUNTIME_CSV_H
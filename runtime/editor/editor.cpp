@@ -0,0 +1,526 @@
+#include "editor.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "../script/script.h"
+#include "../utils/strings.h"
+
+// the maximum number of commands kept in the history
+#define HISTORY_SIZE 1000
+
+// the maximum number of candidates listed by the tab completion
+#define MAX_CANDIDATES 100
+
+// the time to wait for the rest of an escape sequence, in milliseconds
+#define ESCAPE_TIMEOUT 50
+
+namespace HelpyRuntime {
+    /**
+     * @brief The keys that are handled by the editor. Control keys are represented by their ASCII codes, and the
+     * keys that send escape sequences by values above the range of bytes.
+     */
+    enum Key : int {
+        END_OF_INPUT = -1,
+        CTRL_A = 1, CTRL_B = 2, CTRL_C = 3, CTRL_D = 4, CTRL_E = 5, CTRL_F = 6, CTRL_G = 7, CTRL_H = 8, TAB = 9,
+        CTRL_K = 11, CTRL_L = 12, ENTER = 13, CTRL_N = 14, CTRL_P = 16, CTRL_R = 18, CTRL_U = 21, CTRL_W = 23,
+        ESCAPE = 27, BACKSPACE = 127,
+        ARROW_UP = 256, ARROW_DOWN, ARROW_RIGHT, ARROW_LEFT, HOME, END, DELETE
+    };
+
+    /**
+     * @brief Reads a byte from the standard input.
+     * @param c variable which will store the byte
+     * @param timeout the maximum time to wait for the byte, in milliseconds (-1 waits indefinitely)
+     * @return 'true' if a byte was read, 'false' otherwise
+     */
+    static bool readByte(char &c, int timeout = -1) {
+        if (timeout >= 0) {
+            pollfd input{STDIN_FILENO, POLLIN, 0};
+            if (poll(&input, 1, timeout) <= 0) return false;
+        }
+
+        ssize_t size;
+        while ((size = read(STDIN_FILENO, &c, 1)) < 0 && errno == EINTR);
+
+        return size == 1;
+    }
+
+    /**
+     * @brief Reads a key from the standard input, decoding the escape sequences of the arrows and of the
+     * Home, End and Delete keys.
+     * @return the key, or END_OF_INPUT if there is no more input
+     */
+    static int readKey() {
+        char c;
+        if (!readByte(c)) return END_OF_INPUT;
+        if (c != ESCAPE) return (unsigned char) c;
+
+        // a lone Escape is not followed by the rest of a sequence
+        char sequence[3];
+        if (!readByte(sequence[0], ESCAPE_TIMEOUT) || !readByte(sequence[1], ESCAPE_TIMEOUT)) return ESCAPE;
+
+        if (sequence[0] == '[' && sequence[1] >= '0' && sequence[1] <= '9') {
+            if (!readByte(sequence[2], ESCAPE_TIMEOUT) || sequence[2] != '~') return ESCAPE;
+
+            switch (sequence[1]) {
+                case '1' : case '7' : return HOME;
+                case '4' : case '8' : return END;
+                case '3' : return DELETE;
+                default : return ESCAPE;
+            }
+        }
+
+        if (sequence[0] != '[' && sequence[0] != 'O') return ESCAPE;
+
+        switch (sequence[1]) {
+            case 'A' : return ARROW_UP;
+            case 'B' : return ARROW_DOWN;
+            case 'C' : return ARROW_RIGHT;
+            case 'D' : return ARROW_LEFT;
+            case 'H' : return HOME;
+            case 'F' : return END;
+            default : return ESCAPE;
+        }
+    }
+
+    /**
+     * @brief Creates the editor.
+     * @param trie the trie of the words of the commands, which are completed with Tab
+     * @param name the name of the program, which names the file that stores the history in the home directory
+     * (if it is omitted, the history is not saved)
+     */
+    Editor::Editor(CommandTrie trie, const char *name)
+        : trie(trie), line(nullptr), cursor(0) {
+        const char *term = getenv("TERM");
+        enabled = isatty(STDIN_FILENO) && isatty(STDOUT_FILENO) && term && strcmp(term, "dumb") != 0;
+
+        const char *home = getenv("HOME");
+
+        if (enabled && name && home) {
+            historyPath = std::string(home) + "/." + name + "_history";
+            loadHistory();
+        }
+    }
+
+    /**
+     * @brief Loads the history of the previous sessions. The file is compacted if it grew too large.
+     */
+    void Editor::loadHistory() {
+        size_t numLines = 0;
+
+        {
+            Script file(historyPath.c_str());
+            if (!file.isOpen()) return;
+
+            for (std::string_view command; file.nextLine(command); ++numLines) {
+                if (!command.empty()) history.emplace_back(command);
+            }
+        }
+
+        if (history.size() > HISTORY_SIZE)
+            history.erase(history.begin(), history.end() - HISTORY_SIZE);
+
+        if (numLines <= 2 * HISTORY_SIZE) return;
+
+        int fd = open(historyPath.c_str(), O_WRONLY | O_TRUNC);
+        if (fd < 0) return;
+
+        std::string contents;
+
+        for (const std::string &command : history)
+            (contents += command) += '\n';
+
+        if (::write(fd, contents.data(), contents.size()) < 0) { /* the history is not essential */ }
+        close(fd);
+    }
+
+    /**
+     * @brief Adds the line that was read to the history, and appends it to the history file.
+     */
+    void Editor::addToHistory() {
+        size_t end = line->find_last_not_of(" \t");
+        if (end == std::string::npos) return;
+
+        std::string_view command(line->data(), end + 1);
+        if (!history.empty() && history.back() == command) return;
+
+        if (history.size() == HISTORY_SIZE)
+            history.erase(history.begin());
+
+        history.emplace_back(command);
+        if (historyPath.empty()) return;
+
+        int fd = open(historyPath.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0600);
+        if (fd < 0) return;
+
+        std::string entry = history.back() + '\n';
+        if (::write(fd, entry.data(), entry.size()) < 0) { /* the history is not essential */ }
+
+        close(fd);
+    }
+
+    /**
+     * @brief Writes text to the terminal.
+     * @param text the text
+     */
+    void Editor::write(std::string_view text) const {
+        while (!text.empty()) {
+            ssize_t size = ::write(STDOUT_FILENO, text.data(), text.size());
+
+            if (size < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+
+            text.remove_prefix(size);
+        }
+    }
+
+    /**
+     * @brief Redraws the line of the terminal. Lines that do not fit in the terminal are scrolled horizontally, so
+     * the cursor is always visible.
+     * @param prompt the text that precedes the line
+     * @param text the line
+     * @param position the position of the cursor in the line
+     */
+    void Editor::draw(std::string_view prompt, std::string_view text, size_t position) {
+        winsize window{};
+        size_t columns = (ioctl(STDOUT_FILENO, TIOCGWINSZ, &window) == 0 && window.ws_col) ? window.ws_col : 80;
+
+        size_t size = prompt.size() + text.size();
+        position += prompt.size();
+
+        size_t begin = (position >= columns) ? position - columns + 1 : 0;
+        size_t end = std::min(size, begin + columns - 1);
+
+        output.assign("\r");
+
+        for (size_t i = begin; i < end; ++i)
+            output += (i < prompt.size()) ? prompt[i] : text[i - prompt.size()];
+
+        // clear the rest of the line and move the cursor
+        output += "\033[0K\r";
+
+        if (position > begin)
+            output.append("\033[").append(std::to_string(position - begin)).append("C");
+
+        write(output);
+    }
+
+    /**
+     * @brief Redraws the line that is being edited.
+     */
+    void Editor::refresh() {
+        draw("", *line, cursor);
+    }
+
+    /**
+     * @brief Inserts text at the cursor.
+     * @param text the text
+     */
+    void Editor::insert(std::string_view text) {
+        line->insert(cursor, text);
+        cursor += text.size();
+    }
+
+    /**
+     * @brief Completes the word before the cursor with the keywords that can follow the previous words. If there
+     * are several, their longest common prefix is inserted and, if there is none, they are listed below the line.
+     * @param list boolean indicating if the candidates may be listed (i.e. if Tab was pressed twice)
+     */
+    void Editor::complete(bool list) {
+        lowercase.assign(*line, 0, cursor);
+        Utils::toLowercase(lowercase);
+
+        auto [begin, end] = trie.candidates(lowercase);
+
+        if (begin == end) {
+            write("\a");
+            return;
+        }
+
+        size_t wordStart = lowercase.find_last_of(" \t");
+        size_t typed = cursor - ((wordStart == std::string::npos) ? 0 : wordStart + 1);
+
+        // a single candidate is completed, followed by a space
+        if (end - begin == 1) {
+            insert(begin->word.substr(typed));
+            if (cursor == line->size() || (*line)[cursor] != ' ') insert(" ");
+
+            return;
+        }
+
+        // the candidates are sorted, so their longest common prefix is that of the first and the last
+        std::string_view first = begin->word, last = (end - 1)->word;
+
+        size_t common = 0;
+        while (common < first.size() && common < last.size() && first[common] == last[common]) ++common;
+
+        if (common > typed) {
+            insert(first.substr(typed, common - typed));
+            return;
+        }
+
+        if (!list) {
+            write("\a");
+            return;
+        }
+
+        output.assign("\r\n");
+
+        for (auto edge = begin; edge != end && edge - begin < MAX_CANDIDATES; ++edge)
+            output.append(edge->word).append("  ");
+
+        if (end - begin > MAX_CANDIDATES)
+            output.append("(").append(std::to_string(end - begin - MAX_CANDIDATES)).append(" more)");
+
+        output += "\r\n";
+        write(output);
+    }
+
+    /**
+     * @brief Searches the history incrementally, from the most recent command to the oldest. Ctrl-R finds the
+     * next (older) match, and Ctrl-G or Ctrl-C cancel the search.
+     * @return the key that ended the search, which must be handled by the editor (0 if there is none)
+     */
+    int Editor::search() {
+        std::string query, prompt, original = *line;
+        size_t originalCursor = cursor;
+
+        size_t match = history.size(), position = 0;
+
+        // finds the most recent command before 'from' that contains the query
+        auto find = [&](size_t from) {
+            for (size_t i = from; i-- > 0; ) {
+                size_t pos = history[i].find(query);
+                if (pos == std::string::npos) continue;
+
+                match = i;
+                position = pos;
+
+                return;
+            }
+        };
+
+        for (;;) {
+            prompt.assign("(reverse-i-search)`").append(query).append("': ");
+            draw(prompt, (match < history.size()) ? history[match] : std::string_view(), position);
+
+            int key = readKey();
+
+            if (key == CTRL_R) {
+                if (!query.empty()) find(match);
+            }
+            else if (key == BACKSPACE || key == CTRL_H) {
+                if (query.empty()) continue;
+
+                query.pop_back();
+                match = history.size();
+                position = 0;
+
+                if (!query.empty()) find(history.size());
+            }
+            else if (key >= ' ' && key < BACKSPACE) {
+                query += (char) key;
+
+                size_t pos = (match < history.size()) ? history[match].find(query) : std::string::npos;
+                (pos != std::string::npos) ? (void) (position = pos) : find(match);
+            }
+            else if (key == CTRL_G || key == CTRL_C) {
+                *line = original;
+                cursor = originalCursor;
+
+                return 0;
+            }
+            else {
+                if (match < history.size()) {
+                    *line = history[match];
+                    cursor = position;
+                }
+
+                return key;
+            }
+        }
+    }
+
+    /**
+     * @brief Verifies if the editor is enabled, which is the case when the standard input and output are terminals.
+     * @return 'true' if the editor is enabled, 'false' otherwise
+     */
+    bool Editor::isEnabled() const {
+        return enabled;
+    }
+
+    /**
+     * @brief Reads a line from the terminal, in raw mode.
+     * @param line string which will store the line
+     * @param command boolean indicating if the line is a command, which can be completed and is saved in the history
+     * @return 'true' if a line was read, 'false' if there is no more input
+     */
+    bool Editor::readLine(std::string &line, bool command) {
+        termios original{};
+
+        if (tcgetattr(STDIN_FILENO, &original) < 0) {
+            enabled = false;
+            return false;
+        }
+
+        termios raw = original;
+        raw.c_iflag &= ~(BRKINT | ICRNL | INPCK | ISTRIP | IXON);
+        raw.c_lflag &= ~(ECHO | ICANON | IEXTEN | ISIG);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+
+        tcsetattr(STDIN_FILENO, TCSADRAIN, &raw);
+
+        this->line = &line;
+        line.clear();
+        cursor = 0;
+
+        bool completion = command && !trie.empty();
+        size_t index = history.size(); // the position in the history
+        std::string edited; // the line that was being edited before navigating the history
+
+        bool done = false, eof = false, tabbed = false;
+        refresh();
+
+        while (!done) {
+            int key = readKey();
+            bool tab = false;
+
+            if (key == CTRL_R && command)
+                key = search();
+
+            switch (key) {
+                case END_OF_INPUT :
+                    done = eof = true;
+                    break;
+
+                case ENTER :
+                    done = true;
+                    break;
+
+                case CTRL_C :
+                    // restore the terminal before the (default) handler terminates the program
+                    write("^C\n");
+                    tcsetattr(STDIN_FILENO, TCSADRAIN, &original);
+                    raise(SIGINT);
+                    tcsetattr(STDIN_FILENO, TCSADRAIN, &raw);
+
+                    line.clear();
+                    cursor = 0;
+                    break;
+
+                case CTRL_D :
+                    if (line.empty())
+                        done = eof = true;
+                    else if (cursor < line.size())
+                        line.erase(cursor, 1);
+
+                    break;
+
+                case TAB :
+                    if (completion) complete(tabbed);
+                    tab = true;
+                    break;
+
+                case BACKSPACE :
+                case CTRL_H :
+                    if (cursor) line.erase(--cursor, 1);
+                    break;
+
+                case DELETE :
+                    if (cursor < line.size()) line.erase(cursor, 1);
+                    break;
+
+                case ARROW_LEFT :
+                case CTRL_B :
+                    if (cursor) --cursor;
+                    break;
+
+                case ARROW_RIGHT :
+                case CTRL_F :
+                    if (cursor < line.size()) ++cursor;
+                    break;
+
+                case HOME :
+                case CTRL_A :
+                    cursor = 0;
+                    break;
+
+                case END :
+                case CTRL_E :
+                    cursor = line.size();
+                    break;
+
+                case CTRL_K :
+                    line.erase(cursor);
+                    break;
+
+                case CTRL_U :
+                    line.erase(0, cursor);
+                    cursor = 0;
+                    break;
+
+                case CTRL_W : {
+                    size_t begin = cursor;
+
+                    while (begin && line[begin - 1] == ' ') --begin;
+                    while (begin && line[begin - 1] != ' ') --begin;
+
+                    line.erase(begin, cursor - begin);
+                    cursor = begin;
+                    break;
+                }
+
+                case CTRL_L :
+                    write("\033[H\033[2J");
+                    break;
+
+                case ARROW_UP :
+                case CTRL_P :
+                case ARROW_DOWN :
+                case CTRL_N : {
+                    if (!command) break;
+
+                    bool up = key == ARROW_UP || key == CTRL_P;
+                    if (up ? !index : index == history.size()) break;
+
+                    if (index == history.size()) edited = line;
+                    index += up ? -1 : 1;
+
+                    line = (index == history.size()) ? edited : history[index];
+                    cursor = line.size();
+                    break;
+                }
+
+                default :
+                    // printable characters, including the bytes of UTF-8 sequences
+                    if (key >= ' ' && key < ARROW_UP && key != BACKSPACE) {
+                        char c = (char) key;
+                        insert(std::string_view(&c, 1));
+                    }
+            }
+
+            tabbed = tab;
+            if (!done) refresh();
+        }
+
+        refresh();
+        write("\n");
+
+        tcsetattr(STDIN_FILENO, TCSADRAIN, &original);
+        if (command && !eof) addToHistory();
+
+        return !eof || !line.empty();
+    }
+}
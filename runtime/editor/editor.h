@@ -0,0 +1,55 @@
+#ifndef HELPY_RUNTIME_EDITOR_H
+#define HELPY_RUNTIME_EDITOR_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "trie.h"
+
+namespace HelpyRuntime {
+    /**
+     * @brief A line editor for terminals, which puts the terminal in raw mode while a line is being read.
+     *
+     * Besides the usual editing keys (arrows, Home/End, Backspace/Delete, Ctrl-A/E/K/U/W), it offers:
+     * - tab completion of commands, driven by the trie of their words (a second Tab lists the candidates);
+     * - a history of commands, navigated with the up and down arrows, which persists across sessions;
+     * - incremental reverse search of the history (Ctrl-R).
+     *
+     * It is only enabled when both the standard input and output are terminals.
+     */
+    class Editor {
+        CommandTrie trie;
+        std::vector<std::string> history;
+        std::string historyPath;
+        bool enabled;
+
+        // the state of the line being read
+        std::string *line;
+        size_t cursor;
+        std::string lowercase; // the line up to the cursor, in lowercase
+        std::string output; // the escape sequences that redraw the line
+
+    /* CONSTRUCTOR */
+    public:
+        explicit Editor(CommandTrie trie = {}, const char *name = nullptr);
+
+    /* METHODS */
+    private:
+        void loadHistory();
+        void addToHistory();
+
+        void write(std::string_view text) const;
+        void draw(std::string_view prompt, std::string_view text, size_t position);
+        void refresh();
+        void insert(std::string_view text);
+        void complete(bool list);
+        int search();
+
+    public:
+        [[nodiscard]] bool isEnabled() const;
+        bool readLine(std::string &line, bool command);
+    };
+}
+
+#endif //HELPY_RUNTIME_EDITOR_H
@@ -0,0 +1,231 @@
+#include "trie.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../utils/numbers.h"
+
+namespace HelpyRuntime {
+    /**
+     * @brief Computes the distance between two signatures, i.e. the sum of the absolute differences of their counts.
+     * @param lhs the first signature
+     * @param rhs the second signature
+     * @return the distance between the signatures
+     */
+    static inline unsigned signatureDistance(uint64_t lhs, uint64_t rhs) {
+        constexpr uint64_t LOW = 0x0F0F0F0F0F0F0F0Full;
+
+#if defined(__SSE2__)
+        // split the counts into bytes, whose absolute differences are summed by a single instruction
+        __m128i lhs_ = _mm_set_epi64x((long long) ((lhs >> 4) & LOW), (long long) (lhs & LOW));
+        __m128i rhs_ = _mm_set_epi64x((long long) ((rhs >> 4) & LOW), (long long) (rhs & LOW));
+        __m128i sums = _mm_sad_epu8(lhs_, rhs_);
+
+        return (unsigned) (_mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4));
+#else
+        unsigned distance = 0;
+
+        for (int shift = 0; shift < 64; shift += 4) {
+            int difference = (int) ((lhs >> shift) & 15) - (int) ((rhs >> shift) & 15);
+            distance += (difference < 0) ? -difference : difference;
+        }
+
+        return distance;
+#endif
+    }
+
+    /**
+     * @brief Computes the edit (Levenshtein) distance between a pattern and a text, with the bit-parallel algorithm
+     * of Myers, as adapted by Hyyrö to compute the distance between whole strings. Each column of the dynamic
+     * programming matrix is computed in a constant number of operations, as the pattern fits in a machine word.
+     * @param peq the masks of the pattern, i.e. the positions of the pattern where each character occurs
+     * @param length the length of the pattern, which must not exceed 64
+     * @param text the text
+     * @param maxDistance the maximum distance of interest
+     * @return the edit distance, or any value greater than maxDistance if it exceeds it
+     */
+    static size_t editDistance(const uint64_t *peq, size_t length, std::string_view text, size_t maxDistance) {
+        if (!length) return text.size();
+
+        uint64_t pv = ~0ull, mv = 0, last = 1ull << (length - 1);
+        size_t distance = length;
+
+        for (size_t i = 0; i < text.size(); ++i) {
+            uint64_t eq = peq[(unsigned char) text[i]];
+            uint64_t xv = eq | mv;
+            uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+
+            if (ph & last) ++distance;
+            else if (mh & last) --distance;
+
+            // the distance decreases by at most one per remaining character
+            if (distance > maxDistance + text.size() - i - 1) return maxDistance + 1;
+
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+        }
+
+        return distance;
+    }
+
+    /**
+     * @brief Finds the keywords that can complete the last word of a line, given the words before it.
+     * @complexity O(w * log(n)), where w is the number of words of the line and n is the number of keywords
+     * @param line the line, in lowercase, whose last word is incomplete (or empty, if the line ends with whitespace)
+     * @return the range of the edges whose words start with the last word of the line, sorted by word, which is empty
+     * if no command starts with the words of the line
+     */
+    std::pair<const CommandTrie::Edge *, const CommandTrie::Edge *>
+    CommandTrie::candidates(std::string_view line) const {
+        if (empty()) return {nullptr, nullptr};
+
+        // the last word is the one being typed
+        size_t last = line.size();
+        while (last > 0 && !isspace((unsigned char) line[last - 1])) --last;
+
+        std::string_view prefix = line.substr(last), word;
+        line = line.substr(0, last);
+
+        // follow the complete words
+        const Node *node = nodes;
+
+        for (size_t pos = 0; Utils::nextToken(line, pos, word); ) {
+            const Edge *begin = edges + node->begin, *end = edges + node->end;
+            const Edge *edge = std::lower_bound(begin, end, word, [](const Edge &edge, std::string_view word) {
+                return edge.word < word;
+            });
+
+            if (edge == end || edge->word != word || !edge->node) return {nullptr, nullptr};
+            node = nodes + edge->node;
+        }
+
+        // the words which start with the prefix are contiguous
+        const Edge *begin = edges + node->begin, *end = edges + node->end;
+        begin = std::lower_bound(begin, end, prefix, [](const Edge &edge, std::string_view prefix) {
+            return edge.word < prefix;
+        });
+
+        end = std::upper_bound(begin, end, prefix, [](std::string_view prefix, const Edge &edge) {
+            return prefix < edge.word.substr(0, prefix.size());
+        });
+
+        return {begin, end};
+    }
+
+    /**
+     * @brief Finds the commands that are most similar to the words input, which are useful suggestions when the
+     * words do not form a command.
+     *
+     * The trie is searched depth-first, descending only into the words that are within a small edit distance of the
+     * word input in the same position (about a third of its length, and at least 1). The words of each node are
+     * visited in increasing order of a lower bound of their distance, derived from their lengths and signatures, so
+     * the ranking quickly fills with the most similar commands and the remaining words are discarded without
+     * computing their edit distance.
+     * @param words the words input, in lowercase
+     * @param numWords the number of words
+     * @param suggestions array which will store the suggestions, from the most to the least similar
+     * @param maxSuggestions the capacity of the array
+     * @return the number of suggestions
+     */
+    size_t CommandTrie::suggest(const std::string_view *words, size_t numWords, Suggestion *suggestions,
+                                size_t maxSuggestions) const {
+        if (empty() || !numWords || !maxSuggestions) return 0;
+
+        // the masks of the words input, which are the patterns of the edit distances
+        std::vector<uint64_t> peq(numWords * 256), signatures(numWords);
+
+        for (size_t i = 0; i < numWords; ++i) {
+            if (words[i].size() > 64) return 0;
+
+            for (size_t j = 0; j < words[i].size(); ++j)
+                peq[i * 256 + (unsigned char) words[i][j]] |= 1ull << j;
+
+            signatures[i] = signature(words[i]);
+        }
+
+        // the edges of the current node of each depth which may be within the tolerance, by lower bound of their
+        // distance (the buffers are kept between calls, as the nodes may have many edges)
+        thread_local std::vector<std::vector<std::vector<uint32_t>>> candidates;
+        if (candidates.size() < numWords) candidates.resize(numWords);
+
+        std::vector<std::string_view> path(numWords);
+        std::string command;
+        size_t numSuggestions = 0;
+
+        auto precedes = [&command](size_t distance, const Suggestion &suggestion) {
+            return distance < suggestion.distance || (distance == suggestion.distance && command < suggestion.command);
+        };
+
+        auto visit = [&](auto &visit, const Node &node, size_t depth, size_t distance) -> void {
+            std::string_view word = words[depth];
+            size_t tolerance = std::max<size_t>(1, (word.size() + 2) / 3);
+
+            auto &buckets = candidates[depth];
+            if (buckets.size() <= tolerance) buckets.resize(tolerance + 1);
+
+            for (size_t bound = 0; bound <= tolerance; ++bound)
+                buckets[bound].clear();
+
+            for (const Edge *edge = edges + node.begin; edge != edges + node.end; ++edge) {
+                // the commands must have as many words as were input
+                if (!edge->node != (depth + 1 == numWords)) continue;
+
+                size_t length = edge->word.size();
+                size_t bound = std::max(length, word.size()) - std::min(length, word.size());
+                if (bound > tolerance) continue;
+
+                bound = std::max<size_t>(bound, (signatureDistance(edge->signature, signatures[depth]) + 1) / 2);
+                if (bound <= tolerance) buckets[bound].push_back(edge - edges);
+            }
+
+            for (size_t bound = 0; bound <= tolerance; ++bound) {
+                for (uint32_t index : buckets[bound]) {
+                    // once the ranking is full, only the commands more similar than the last one are of interest
+                    size_t maxDistance = tolerance;
+
+                    if (numSuggestions == maxSuggestions) {
+                        if (suggestions[numSuggestions - 1].distance <= distance + bound) return;
+                        maxDistance = std::min(maxDistance, suggestions[numSuggestions - 1].distance - distance - 1);
+                    }
+
+                    const Edge &edge = edges[index];
+                    size_t distance_ = editDistance(&peq[depth * 256], word.size(), edge.word, maxDistance);
+                    if (distance_ > maxDistance) continue;
+
+                    path[depth] = edge.word;
+                    distance_ += distance;
+
+                    if (edge.node) {
+                        visit(visit, nodes[edge.node], depth + 1, distance_);
+                        continue;
+                    }
+
+                    // insert the command in the ranking
+                    command.clear();
+
+                    for (size_t i = 0; i < numWords; ++i)
+                        (command += (i ? " " : "")) += path[i];
+
+                    size_t pos = (numSuggestions < maxSuggestions) ? numSuggestions++ : maxSuggestions - 1;
+
+                    for (; pos && precedes(distance_, suggestions[pos - 1]); --pos)
+                        std::swap(suggestions[pos], suggestions[pos - 1]);
+
+                    suggestions[pos].distance = distance_;
+                    suggestions[pos].command = command;
+                }
+            }
+        };
+
+        visit(visit, nodes[0], 0, 0);
+        return numSuggestions;
+    }
+}
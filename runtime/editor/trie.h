@@ -0,0 +1,69 @@
+#ifndef HELPY_RUNTIME_TRIE_H
+#define HELPY_RUNTIME_TRIE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace HelpyRuntime {
+    /**
+     * @brief The trie of the words of the commands, which is generated from the specification and used to complete
+     * commands as they are typed and to suggest commands when an unknown command is input.
+     *
+     * Each node stores the range of its outgoing edges, which are sorted by word, so the keywords that can complete
+     * a word are found with two binary searches per word of the command.
+     */
+    struct CommandTrie {
+        struct Node {
+            uint32_t begin, end; // the range of the edges of the node
+        };
+
+        struct Edge {
+            std::string_view word;
+            uint32_t node; // the node the edge leads to, or 0 if the word is the last of a command
+            uint64_t signature; // the signature of the word (see signature())
+        };
+
+        struct Suggestion {
+            size_t distance; // the sum of the edit distances between the words input and those of the command
+            std::string command;
+        };
+
+        const Node *nodes = nullptr;
+        const Edge *edges = nullptr;
+
+    /* METHODS */
+    public:
+        [[nodiscard]] bool empty() const {
+            return !nodes;
+        }
+
+        [[nodiscard]] std::pair<const Edge *, const Edge *> candidates(std::string_view line) const;
+        size_t suggest(const std::string_view *words, size_t numWords, Suggestion *suggestions,
+                       size_t maxSuggestions) const;
+
+        /**
+         * @brief Computes the signature of a word, i.e. the number of occurrences of each of 16 classes of characters
+         * (saturated at 15), stored in 4 bits each. Half the distance between the signatures of two words is a lower
+         * bound of their edit distance, so most keywords are discarded without computing it.
+         *
+         * The signatures of the keywords are computed by Helpy when the code is generated, which must be done in the
+         * same way.
+         * @param word the word
+         * @return the signature of the word
+         */
+        static constexpr uint64_t signature(std::string_view word) {
+            uint64_t signature = 0;
+
+            for (char c : word) {
+                int shift = (c & 15) * 4;
+                if (((signature >> shift) & 15) < 15) signature += (uint64_t) 1 << shift;
+            }
+
+            return signature;
+        }
+    };
+}
+
+#endif //HELPY_RUNTIME_TRIE_H
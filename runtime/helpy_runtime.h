@@ -0,0 +1,29 @@
+/** @file */
+
+#ifndef HELPY_RUNTIME_H
+#define HELPY_RUNTIME_H
+
+#include "version.h"
+
+#include "bench/bench.h"
+#include "cache/cache.h"
+#include "compose/compose.h"
+#include "console/console.h"
+#include "coro/coro.h"
+#include "csv/csv.h"
+#include "editor/editor.h"
+#include "io/io.h"
+#include "jobs/jobs.h"
+#include "log/log.h"
+#include "output/output.h"
+#include "plugin/plugin.h"
+#include "replay/replay.h"
+#include "script/script.h"
+#include "server/server.h"
+#include "stats/stats.h"
+#include "trace/trace.h"
+#include "usage/usage.h"
+#include "utils/numbers.h"
+#include "utils/utils.h"
+
+#endif //HELPY_RUNTIME_H
@@ -0,0 +1,31 @@
+/** @file */
+
+#ifndef HELPY_RUNTIME_LITE_H
+#define HELPY_RUNTIME_LITE_H
+
+/*
+ * The runtime of the lightweight backend (helpy run --backend lite), which does not depend on iostreams.
+ */
+#include "version.h"
+
+#include "bench/bench.h"
+#include "cache/cache.h"
+#include "compose/compose.h"
+#include "coro/coro.h"
+#include "csv/csv.h"
+#include "editor/editor.h"
+#include "io/io.h"
+#include "jobs/jobs.h"
+#include "lite/console.h"
+#include "log/log.h"
+#include "plugin/plugin.h"
+#include "replay/replay.h"
+#include "script/script.h"
+#include "server/server.h"
+#include "stats/stats.h"
+#include "trace/trace.h"
+#include "usage/usage.h"
+#include "utils/numbers.h"
+#include "utils/strings.h"
+
+#endif //HELPY_RUNTIME_LITE_H
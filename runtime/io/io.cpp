@@ -0,0 +1,438 @@
+#include "io.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+
+// the states of the parser of ANSI escape sequences
+#define TEXT        0
+#define ESCAPE      1
+#define CSI         2
+
+namespace HelpyRuntime::IO {
+    Writer out(STDOUT_FILENO, false), err(STDERR_FILENO, true);
+    Reader in(STDIN_FILENO);
+
+    // the string the output of the calling thread is redirected to, if any (see Capture)
+    static thread_local std::string *captured = nullptr;
+
+    // the string the output of the calling thread is copied to, if any (see Tee)
+    static thread_local std::string *teed = nullptr;
+
+    // the source the input of the calling thread is redirected to, if any (see Feed)
+    static thread_local Feed *fed = nullptr;
+
+    // the lines the calling thread read from the console, if they are recorded (see Record)
+    static thread_local std::vector<std::string> *recorded = nullptr;
+
+    /**
+     * @brief Flushes the standard output, which is the default behavior of the streams that are tied to it.
+     */
+    static void flushOut() {
+        out.flush();
+    }
+
+    /**
+     * @brief Verifies if the output written to a file descriptor can be styled with ANSI escape sequences, which is
+     * the case when it is a terminal and the NO_COLOR environment variable is not set.
+     * @param fd the file descriptor
+     * @return 'true' if the output supports colors, 'false' otherwise
+     */
+    static bool supportsColors(int fd) {
+        const char *noColor = getenv("NO_COLOR");
+        return isatty(fd) && !(noColor && *noColor);
+    }
+
+    /**
+     * @brief Writes data to a file descriptor, retrying if the write is interrupted or partial.
+     * @param fd the file descriptor
+     * @param data the data
+     * @param size the size of the data
+     */
+    static void writeAll(int fd, const char *data, size_t size) {
+        while (size) {
+            ssize_t written = ::write(fd, data, size);
+
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+
+            data += written;
+            size -= written;
+        }
+    }
+
+    /**
+     * @brief Removes the ANSI escape sequences from a piece of output. Sequences that are split across several
+     * pieces are also removed, since the state of the parser is preserved between calls.
+     * @param data the piece of output, which is modified in place
+     * @param size the size of the piece
+     * @param state the state of the parser, which must be 0 before the first piece
+     * @return the size of the piece without the escape sequences
+     */
+    size_t stripEscapes(char *data, size_t size, int &state) {
+        size_t j = 0;
+
+        for (size_t i = 0; i < size; ++i) {
+            char c = data[i];
+
+            switch (state) {
+                case TEXT :
+                    if (c == '\033') state = ESCAPE;
+                    else data[j++] = c;
+
+                    break;
+
+                case ESCAPE :
+                    state = (c == '[') ? CSI : TEXT;
+                    break;
+
+                case CSI :
+                    // the final byte of a control sequence is in the range [0x40, 0x7E]
+                    if (c >= 0x40 && c <= 0x7E) state = TEXT;
+                    break;
+            }
+        }
+
+        return j;
+    }
+
+    /**
+     * @brief Creates an output stream.
+     * @param fd the file descriptor the stream writes to
+     * @param unitbuf boolean indicating if the stream should be flushed after every operation
+     */
+    Writer::Writer(int fd, bool unitbuf)
+        : fd(fd), colored(supportsColors(fd)), unitbuf(unitbuf), escape(TEXT),
+          tied(fd == STDOUT_FILENO ? nullptr : flushOut), size(0) {}
+
+    /**
+     * @brief Writes the remaining output.
+     */
+    Writer::~Writer() {
+        flush();
+    }
+
+    /**
+     * @brief Appends data to the buffer, writing the buffer when it becomes full.
+     * @param data the data
+     * @param length the size of the data
+     */
+    void Writer::append(const char *data, size_t length) {
+        if (teed && fd == STDOUT_FILENO) teed->append(data, length);
+
+        if (captured) {
+            captured->append(data, length);
+            return;
+        }
+
+        if (size + length > sizeof(buffer)) {
+            flush();
+
+            // data that does not fit in the buffer is written directly
+            if (length > sizeof(buffer)) {
+                char copy[HELPY_IO_BUFFER_SIZE];
+
+                for (size_t i = 0; i < length; i += sizeof(copy)) {
+                    size_t chunk = std::min(sizeof(copy), length - i);
+                    std::memcpy(copy, data + i, chunk);
+
+                    writeAll(fd, copy, colored ? chunk : stripEscapes(copy, chunk, escape));
+                }
+
+                return;
+            }
+        }
+
+        std::memcpy(buffer + size, data, length);
+        size += length;
+    }
+
+    /**
+     * @brief Writes the buffered output.
+     */
+    void Writer::flush() {
+        // the buffer belongs to the threads whose output is not captured
+        if (captured) return;
+
+        if (tied) tied();
+        if (!size) return;
+
+        writeAll(fd, buffer, colored ? size : stripEscapes(buffer, size, escape));
+        size = 0;
+    }
+
+    /**
+     * @brief Ties the stream to another output, which is flushed before anything is written to this stream.
+     * @param flush the function that flushes the other output
+     */
+    void Writer::tie(void (*flush)()) {
+        tied = flush;
+    }
+
+    /**
+     * @brief Verifies if the output can be styled with ANSI escape sequences.
+     * @return 'true' if the output supports colors, 'false' otherwise
+     */
+    bool Writer::colorsEnabled() const {
+        return colored;
+    }
+
+    /**
+     * @brief Writes a character.
+     * @param c the character
+     * @return the stream
+     */
+    Writer &Writer::operator<<(char c) {
+        append(&c, 1);
+        return done();
+    }
+
+    /**
+     * @brief Writes a string.
+     * @param string the string
+     * @return the stream
+     */
+    Writer &Writer::operator<<(std::string_view string) {
+        append(string.data(), string.size());
+        return done();
+    }
+
+    /**
+     * @brief Writes a floating-point number, with the same format as std::ostream (i.e. %g with 6 significant digits).
+     * @param number the number
+     * @return the stream
+     */
+    Writer &Writer::operator<<(double number) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), number, std::chars_format::general, 6);
+
+        append(digits, result.ptr - digits);
+        return done();
+    }
+
+    /**
+     * @brief Starts redirecting the output of the calling thread to a string.
+     * @param output the string, to which the output is appended
+     */
+    Capture::Capture(std::string &output) : previous(captured) {
+        captured = &output;
+    }
+
+    /**
+     * @brief Stops redirecting the output of the calling thread, which is once again redirected to where it was
+     * before (usually, nowhere).
+     */
+    Capture::~Capture() {
+        captured = previous;
+    }
+
+    /**
+     * @brief Returns the string the output of the calling thread is redirected to.
+     * @return the string, or nullptr if the output of the thread is not redirected
+     */
+    std::string *Capture::current() {
+        return captured;
+    }
+
+    /**
+     * @brief Starts copying the output of the calling thread to a string.
+     * @param output the string, to which the output is appended
+     */
+    Tee::Tee(std::string &output) : previous(teed) {
+        teed = &output;
+    }
+
+    /**
+     * @brief Stops copying the output of the calling thread.
+     */
+    Tee::~Tee() {
+        teed = previous;
+    }
+
+    /**
+     * @brief Returns the string the output of the calling thread is copied to.
+     * @return the string, or nullptr if the output of the thread is not copied
+     */
+    std::string *Tee::current() {
+        return teed;
+    }
+
+    /**
+     * @brief Starts redirecting the input of the calling thread to a source of lines.
+     * @param source the function that reads the next line, which returns 'false' if there are no more lines
+     */
+    Feed::Feed(std::function<bool(std::string &line)> source) : source(std::move(source)), previous(fed) {
+        fed = this;
+    }
+
+    /**
+     * @brief Stops redirecting the input of the calling thread.
+     */
+    Feed::~Feed() {
+        fed = previous;
+    }
+
+    /**
+     * @brief Reads the next line from the source. Like the console, leading whitespace and blank lines are skipped.
+     * @return the line, which is valid until the next line is read
+     * @throws std::runtime_error if the source has no more lines, since the input the command expects will never come
+     */
+    const std::string &Feed::readLine() {
+        do {
+            line.clear();
+
+            if (!source(line))
+                throw std::runtime_error("the input ended");
+
+            line.erase(0, line.find_first_not_of(" \t"));
+        } while (line.empty());
+
+        return line;
+    }
+
+    /**
+     * @brief Returns the source the input of the calling thread is redirected to.
+     * @return the source, or nullptr if the input of the thread is not redirected
+     */
+    Feed *Feed::current() {
+        return fed;
+    }
+
+    /**
+     * @brief Starts recording the lines the calling thread reads from the console.
+     * @param lines the vector to which the lines are appended
+     */
+    Record::Record(std::vector<std::string> &lines) : previous(recorded) {
+        recorded = &lines;
+    }
+
+    /**
+     * @brief Stops recording the lines the calling thread reads.
+     */
+    Record::~Record() {
+        recorded = previous;
+    }
+
+    /**
+     * @brief Returns the vector the lines the calling thread reads are appended to.
+     * @return the vector, or nullptr if the lines are not recorded
+     */
+    std::vector<std::string> *Record::current() {
+        return recorded;
+    }
+
+    /**
+     * @brief Creates an input stream.
+     * @param fd the file descriptor the stream reads from
+     */
+    Reader::Reader(int fd) : fd(fd), eof(false), tied(flushOut), begin(0), end(0) {}
+
+    /**
+     * @brief Reads more input into the buffer, after flushing the output the stream is tied to.
+     * @return 'true' if any input was read, 'false' if the end of the input was reached
+     */
+    bool Reader::fill() {
+        if (eof) return false;
+        if (tied) tied();
+
+        ssize_t size;
+        while ((size = read(fd, buffer, sizeof(buffer))) < 0 && errno == EINTR);
+
+        if (size <= 0) {
+            eof = true;
+            return false;
+        }
+
+        begin = 0;
+        end = size;
+
+        return true;
+    }
+
+    /**
+     * @brief Ties the stream to an output, which is flushed before the stream blocks on input.
+     * @param flush the function that flushes the output
+     */
+    void Reader::tie(void (*flush)()) {
+        tied = flush;
+    }
+
+    /**
+     * @brief Discards the leading whitespace of the input (like std::ws).
+     */
+    void Reader::skipWhitespace() {
+        for (;;) {
+            while (begin < end && isspace((unsigned char) buffer[begin])) ++begin;
+            if (begin < end || !fill()) return;
+        }
+    }
+
+    /**
+     * @brief Reads a line of input (like std::getline).
+     * @param line string which will store the line, without the line terminator
+     * @return 'true' if a line was read, 'false' if the end of the input was reached
+     */
+    bool Reader::readLine(std::string &line) {
+        line.clear();
+
+        for (bool read = false;; read = true) {
+            if (begin == end && !fill()) return read;
+
+            auto *newline = (const char *) std::memchr(buffer + begin, '\n', end - begin);
+            size_t lineEnd = newline ? newline - buffer : end;
+
+            line.append(buffer + begin, lineEnd - begin);
+            begin = lineEnd;
+
+            if (newline) {
+                ++begin;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Reads a word, i.e. a sequence of characters delimited by whitespace (like std::istream::operator>>).
+     * If the end of the input is reached before a word is found, the string is left unchanged.
+     * @param word string which will store the word
+     * @return the stream
+     */
+    Reader &Reader::operator>>(std::string &word) {
+        skipWhitespace();
+        if (begin == end) return *this;
+
+        word.clear();
+
+        for (;;) {
+            size_t start = begin;
+            while (begin < end && !isspace((unsigned char) buffer[begin])) ++begin;
+
+            word.append(buffer + start, begin - start);
+            if (begin < end || !fill()) return *this;
+        }
+    }
+
+    /**
+     * @brief Ends a line. Like Output, the stream is not flushed, so printing lines does not require a system call.
+     * @param writer the stream
+     * @return the stream
+     */
+    Writer &endl(Writer &writer) {
+        return writer << '\n';
+    }
+
+    /**
+     * @brief Does not flush the stream, for the same reason as IO::endl. Use Writer::flush() to flush it.
+     * @param writer the stream
+     * @return the stream
+     */
+    Writer &flush(Writer &writer) {
+        return writer;
+    }
+}
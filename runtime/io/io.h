@@ -0,0 +1,229 @@
+#ifndef HELPY_RUNTIME_IO_H
+#define HELPY_RUNTIME_IO_H
+
+#include <charconv>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// the size of the buffers of the streams
+#define HELPY_IO_BUFFER_SIZE (1 << 16)
+
+namespace HelpyRuntime::IO {
+    size_t stripEscapes(char *data, size_t size, int &state);
+
+    /**
+     * @brief A buffered output stream that writes to a file descriptor, which is used by the generated code instead
+     * of std::ostream when it is written for the lightweight backend (helpy run --backend lite).
+     *
+     * It follows the same policy as Output: the buffer is only written when it is full, when it is explicitly
+     * flushed, before input is read and at exit, and ANSI escape sequences are removed when the file descriptor
+     * is not a terminal.
+     */
+    class Writer {
+        int fd;
+        bool colored, unitbuf;
+        int escape;
+
+        void (*tied)();
+
+        char buffer[HELPY_IO_BUFFER_SIZE];
+        size_t size;
+
+    /* CONSTRUCTOR */
+    public:
+        Writer(int fd, bool unitbuf);
+        Writer(const Writer &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~Writer();
+
+    /* METHODS */
+    private:
+        void append(const char *data, size_t length);
+
+        /**
+         * @brief Flushes the stream after each operation, if it is unit-buffered (like std::cerr).
+         * @return the stream
+         */
+        Writer &done() {
+            if (unitbuf) flush();
+            return *this;
+        }
+
+    public:
+        void flush();
+        void tie(void (*flush)());
+        [[nodiscard]] bool colorsEnabled() const;
+
+        Writer &operator<<(char c);
+        Writer &operator<<(std::string_view string);
+        Writer &operator<<(double number);
+
+        Writer &operator<<(const char *string) {
+            return *this << std::string_view(string);
+        }
+
+        Writer &operator<<(const std::string &string) {
+            return *this << std::string_view(string);
+        }
+
+        Writer &operator<<(bool value) {
+            return *this << (value ? '1' : '0');
+        }
+
+        /**
+         * @brief Writes an integer.
+         * @param number the integer
+         * @return the stream
+         */
+        template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+        Writer &operator<<(T number) {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), number);
+
+            append(digits, result.ptr - digits);
+            return done();
+        }
+
+        /**
+         * @brief Applies a manipulator (e.g. IO::endl) to the stream.
+         * @param manipulator the manipulator
+         * @return the stream
+         */
+        Writer &operator<<(Writer &(*manipulator)(Writer &)) {
+            return manipulator(*this);
+        }
+    };
+
+    /**
+     * @brief A buffered input stream that reads lines and words from a file descriptor.
+     *
+     * Before blocking on input, it flushes the output stream it is tied to, so prompts are always visible.
+     */
+    class Reader {
+        int fd;
+        bool eof;
+
+        void (*tied)();
+
+        char buffer[HELPY_IO_BUFFER_SIZE];
+        size_t begin, end;
+
+    /* CONSTRUCTOR */
+    public:
+        explicit Reader(int fd);
+        Reader(const Reader &) = delete;
+
+    /* METHODS */
+    private:
+        bool fill();
+
+    public:
+        void tie(void (*flush)());
+        void skipWhitespace();
+        bool readLine(std::string &line);
+        Reader &operator>>(std::string &word);
+    };
+
+    /**
+     * @brief Redirects the output of the calling thread to a string while it exists, so commands that run in the
+     * background (see JobPool) do not write over the console while the user is typing. It applies to IO::out and
+     * IO::err and, once Output is installed and shared, to std::cout.
+     */
+    class Capture {
+        std::string *previous;
+
+    /* CONSTRUCTOR */
+    public:
+        explicit Capture(std::string &output);
+        Capture(const Capture &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~Capture();
+
+    /* METHODS */
+    public:
+        static std::string *current();
+    };
+
+    /**
+     * @brief Copies the output of the calling thread to a string while it exists, without redirecting it, so the
+     * output of the commands can be cached (see ResultCache). It applies to IO::out and, once Output is installed and
+     * shared, to std::cout, even if their output is captured.
+     */
+    class Tee {
+        std::string *previous;
+
+    /* CONSTRUCTOR */
+    public:
+        explicit Tee(std::string &output);
+        Tee(const Tee &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~Tee();
+
+    /* METHODS */
+    public:
+        static std::string *current();
+    };
+
+    /**
+     * @brief Redirects the input of the calling thread to a source of lines while it exists, so the commands that run
+     * for a client of the server (see Server) read the lines the client sends instead of the standard input.
+     */
+    class Feed {
+        std::function<bool(std::string &)> source;
+        std::string line;
+        Feed *previous;
+
+    /* CONSTRUCTOR */
+    public:
+        explicit Feed(std::function<bool(std::string &line)> source);
+        Feed(const Feed &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~Feed();
+
+    /* METHODS */
+    public:
+        const std::string &readLine();
+        static Feed *current();
+    };
+
+    /**
+     * @brief Records the lines the calling thread reads from the console while it exists, so a session can be saved
+     * and replayed (see Transcript).
+     */
+    class Record {
+        std::vector<std::string> *previous;
+
+    /* CONSTRUCTOR */
+    public:
+        explicit Record(std::vector<std::string> &lines);
+        Record(const Record &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~Record();
+
+    /* METHODS */
+    public:
+        static std::vector<std::string> *current();
+    };
+
+    Writer &endl(Writer &writer);
+    Writer &flush(Writer &writer);
+
+    extern Writer out, err;
+    extern Reader in;
+}
+
+#endif //HELPY_RUNTIME_IO_H
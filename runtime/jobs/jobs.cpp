@@ -0,0 +1,273 @@
+#include "jobs.h"
+
+#include <algorithm>
+#include <csignal>
+#include <exception>
+
+#include "../io/io.h"
+#include "../trace/trace.h"
+
+// how often a wait verifies if it was interrupted, in milliseconds
+#define WAIT_INTERVAL 50
+
+namespace HelpyRuntime {
+    // the number of times Ctrl-C (SIGINT) was pressed while waiting for jobs
+    static volatile sig_atomic_t interrupts = 0;
+
+    static void interrupt(int) {
+        ++interrupts;
+    }
+
+    /**
+     * @brief Creates the pool, whose workers are only started when the first job is submitted.
+     */
+    JobPool::JobPool() : nextId(1), stopping(false) {}
+
+    /**
+     * @brief Cancels the jobs that did not finish and waits for the workers, since the jobs may use the object that
+     * submitted them.
+     */
+    JobPool::~JobPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+
+            for (const Handle &job : jobs)
+                job->stop = true;
+        }
+
+        work.notify_all();
+
+        for (std::thread &worker : workers)
+            worker.join();
+    }
+
+    /**
+     * @brief Runs the jobs, in the order they were submitted, until the pool is destroyed. The jobs that were
+     * cancelled before starting are not run.
+     */
+    void JobPool::loop() {
+        for (;;) {
+            Handle job;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                work.wait(lock, [this] { return stopping || !queue.empty(); });
+
+                if (queue.empty()) return;
+
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+
+            if (job->stop) {
+                finish(job, State::Cancelled);
+                continue;
+            }
+
+            job->state = State::Running;
+            State state = State::Done;
+
+            try {
+                TraceScope trace(job->name);
+                IO::Capture capture(job->output);
+                job->task(StopToken(job->stop));
+            }
+            catch (const std::exception &e) {
+                job->error = e.what();
+                state = State::Failed;
+            }
+            catch (...) {
+                job->error = "unknown error";
+                state = State::Failed;
+            }
+
+            if (state == State::Done && job->stop) state = State::Cancelled;
+            finish(job, state);
+        }
+    }
+
+    /**
+     * @brief Marks a job as finished and wakes up the threads that wait for it.
+     * @param job the job
+     * @param state the final state of the job
+     */
+    void JobPool::finish(const Handle &job, State state) {
+        job->end = std::chrono::steady_clock::now();
+        job->task = nullptr; // release whatever the task holds
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job->state = state;
+        }
+
+        finished.notify_all();
+    }
+
+    /**
+     * @brief Submits a job, which is run as soon as a worker is available.
+     * @param name the name of the job (e.g. the name of the command), which must outlive the job
+     * @param task the function that executes the job, which receives the token that signals its cancellation
+     * @return the handle of the job
+     */
+    JobPool::Handle JobPool::submit(std::string_view name, std::function<void(const StopToken &)> task) {
+        Handle job = std::make_shared<Job>();
+
+        job->name = name;
+        job->task = std::move(task);
+        job->start = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (workers.empty()) {
+                unsigned numWorkers = std::max(1u, std::thread::hardware_concurrency());
+
+                for (unsigned i = 0; i < numWorkers; ++i)
+                    workers.emplace_back(&JobPool::loop, this);
+            }
+
+            job->id = nextId++;
+            jobs.push_back(job);
+            queue.push_back(job);
+        }
+
+        work.notify_one();
+        return job;
+    }
+
+    /**
+     * @brief Returns the jobs that are queued, running or were not yet reported as finished (see reap()).
+     * @return the jobs, sorted by id
+     */
+    std::vector<JobPool::Handle> JobPool::list() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return jobs;
+    }
+
+    /**
+     * @brief Finds a job that was not yet reported as finished.
+     * @param id the id of the job
+     * @return the handle of the job, or nullptr if there is no such job
+     */
+    JobPool::Handle JobPool::find(size_t id) const {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = std::lower_bound(jobs.begin(), jobs.end(), id, [](const Handle &job, size_t id) {
+            return job->id < id;
+        });
+
+        return (it != jobs.end() && (*it)->id == id) ? *it : nullptr;
+    }
+
+    /**
+     * @brief Verifies if no job is queued or running.
+     * @return 'true' if every job finished, 'false' otherwise
+     */
+    bool JobPool::idle() const {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        return std::all_of(jobs.begin(), jobs.end(), [](const Handle &job) {
+            return job->finished();
+        });
+    }
+
+    /**
+     * @brief Requests a job to stop. Jobs that did not start yet are not run at all.
+     * @param job the job, or nullptr to cancel every job
+     */
+    void JobPool::cancel(const Handle &job) {
+        if (job) {
+            job->stop = true;
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (const Handle &job_ : jobs)
+            job_->stop = true;
+    }
+
+    /**
+     * @brief Waits for a job to finish. Meanwhile, pressing Ctrl-C cancels the job instead of terminating the program,
+     * and pressing it again terminates the program, in case the job does not stop.
+     * @param job the job, or nullptr to wait for every job
+     * @return 'true' if the wait was interrupted (i.e. the job was cancelled), 'false' otherwise
+     */
+    bool JobPool::wait(const Handle &job) {
+        struct sigaction action = {}, previous = {};
+        action.sa_handler = interrupt;
+        sigemptyset(&action.sa_mask);
+
+        interrupts = 0;
+        sigaction(SIGINT, &action, &previous);
+
+        auto done = [this, &job] {
+            return job ? job->finished() : std::all_of(jobs.begin(), jobs.end(), [](const Handle &job) {
+                return job->finished();
+            });
+        };
+
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (!done()) {
+            finished.wait_for(lock, std::chrono::milliseconds(WAIT_INTERVAL));
+            if (!interrupts) continue;
+
+            // the second interrupt has the usual effect
+            if (interrupts > 1) {
+                sigaction(SIGINT, &previous, nullptr);
+                raise(SIGINT);
+            }
+
+            if (job) job->stop = true;
+            else {
+                for (const Handle &job_ : jobs)
+                    job_->stop = true;
+            }
+        }
+
+        lock.unlock();
+        sigaction(SIGINT, &previous, nullptr);
+
+        return interrupts;
+    }
+
+    /**
+     * @brief Removes the jobs that finished, which are no longer listed.
+     * @return the jobs that finished, sorted by id
+     */
+    std::vector<JobPool::Handle> JobPool::reap() {
+        std::vector<Handle> reaped;
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto it = std::stable_partition(jobs.begin(), jobs.end(), [](const Handle &job) {
+            return !job->finished();
+        });
+
+        reaped.assign(std::make_move_iterator(it), std::make_move_iterator(jobs.end()));
+        jobs.erase(it, jobs.end());
+
+        return reaped;
+    }
+
+    /**
+     * @brief Returns the name of a state.
+     * @param state the state
+     * @return the name of the state, in lowercase
+     */
+    const char *JobPool::toString(State state) {
+        switch (state) {
+            case State::Queued :
+                return "queued";
+            case State::Running :
+                return "running";
+            case State::Done :
+                return "done";
+            case State::Cancelled :
+                return "cancelled";
+            default :
+                return "failed";
+        }
+    }
+}
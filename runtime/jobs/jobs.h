@@ -0,0 +1,110 @@
+#ifndef HELPY_RUNTIME_JOBS_H
+#define HELPY_RUNTIME_JOBS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace HelpyRuntime {
+    /**
+     * @brief Allows a command that runs in the background to find out if it was cancelled. Cancellation is
+     * cooperative: the command should check the token regularly and return soon after a stop is requested.
+     */
+    class StopToken {
+        const std::atomic<bool> *stop;
+
+    /* CONSTRUCTOR */
+    public:
+        /**
+         * @brief Creates a token whose stop is never requested, for commands that run in the foreground.
+         */
+        StopToken() : stop(nullptr) {}
+
+        explicit StopToken(const std::atomic<bool> &stop) : stop(&stop) {}
+
+    /* METHODS */
+    public:
+        /**
+         * @brief Verifies if the command was cancelled.
+         * @return 'true' if a stop was requested, 'false' otherwise
+         */
+        [[nodiscard]] bool stopRequested() const {
+            return stop && stop->load(std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief A pool of worker threads that run commands in the background (jobs).
+     *
+     * The workers are only started when the first job is submitted, one per hardware thread. The output of each job
+     * is captured (see IO::Capture) and kept with the job, so it can be displayed once the job finishes.
+     */
+    class JobPool {
+    public:
+        enum class State {
+            Queued, Running, Done, Cancelled, Failed
+        };
+
+        struct Job {
+            size_t id;
+            std::string_view name;
+            std::function<void(const StopToken &)> task;
+            std::atomic<State> state;
+            std::atomic<bool> stop;
+            std::string output; // the output of the job, which must only be read once it finishes
+            std::string error; // the error that made the job fail, if any
+            std::chrono::steady_clock::time_point start, end;
+
+            [[nodiscard]] bool finished() const {
+                return state.load() > State::Running;
+            }
+        };
+
+        using Handle = std::shared_ptr<Job>;
+
+    private:
+        std::vector<std::thread> workers;
+        std::deque<Handle> queue;
+        std::vector<Handle> jobs; // the jobs that were not yet reported as finished, by id
+        size_t nextId;
+        bool stopping;
+
+        mutable std::mutex mutex;
+        std::condition_variable work, finished;
+
+    /* CONSTRUCTOR */
+    public:
+        JobPool();
+        JobPool(const JobPool &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~JobPool();
+
+    /* METHODS */
+    private:
+        void loop();
+        void finish(const Handle &job, State state);
+
+    public:
+        Handle submit(std::string_view name, std::function<void(const StopToken &)> task);
+        [[nodiscard]] std::vector<Handle> list() const;
+        [[nodiscard]] Handle find(size_t id) const;
+        [[nodiscard]] bool idle() const;
+        void cancel(const Handle &job = nullptr);
+        bool wait(const Handle &job = nullptr);
+        std::vector<Handle> reap();
+
+        static const char *toString(State state);
+    };
+}
+
+#endif //HELPY_RUNTIME_JOBS_H
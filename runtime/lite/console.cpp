@@ -0,0 +1,841 @@
+#include "console.h"
+
+#include <algorithm>
+#include <charconv>
+#include <exception>
+#include <filesystem>
+#include <optional>
+#include <unordered_set>
+#include <unistd.h>
+
+#include "../bench/bench.h"
+#include "../cache/cache.h"
+#include "../csv/csv.h"
+#include "../io/io.h"
+#include "../trace/trace.h"
+#include "../utils/numbers.h"
+#include "../utils/strings.h"
+
+// formatting
+#define RESET       "\033[0m"
+
+// output colors
+#define RED         "\033[31m"
+#define GREEN       "\033[32m"
+
+// text
+#define DASHED_LINE "- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -"
+#define BREAK       '\n' << color << DASHED_LINE << RESET << '\n' << IO::endl
+#define YES_NO      " (" GREEN "Yes" RESET "/" RED "No" RESET ")"
+
+#define uSet std::unordered_set
+
+// the maximum number of commands suggested when an unknown command is input
+#define MAX_SUGGESTIONS 3
+
+namespace HelpyRuntime::Lite {
+    /**
+     * @brief Extracts the next path of a line, which is either a word or a sequence of characters between quotation
+     * marks (if the quotation mark immediately follows the previous path).
+     * @param line the line
+     * @param pos the position where the search starts, which is updated to the position after the path
+     * @param path string which will store the path, and is left unchanged if the end of the line was reached
+     * @return 'true' if the end of the line was not reached, 'false' otherwise
+     */
+    static bool nextPath(std::string_view line, size_t &pos, std::string &path) {
+        if (pos < line.size() && line[pos] == '"') {
+            size_t end = line.find('"', ++pos);
+            if (end == std::string_view::npos) end = line.size();
+
+            path = line.substr(pos, end - pos);
+            pos = std::min(end + 1, line.size());
+
+            return true;
+        }
+
+        std::string_view word;
+        if (!Utils::nextToken(line, pos, word)) return false;
+
+        path = word;
+        return true;
+    }
+
+    /**
+     * @brief Creates the console.
+     * @param color the ANSI escape sequence of the main color used to style the command line
+     * @param commands the trie of the words of the commands, which are completed by the line editor
+     * @param name the name of the program, which names the file that stores the history of commands
+     */
+    Console::Console(const char *color, CommandTrie commands, const char *name)
+        : color(color), commands(commands), editor(commands, name) {}
+
+    /**
+     * @brief Verifies if the output can be styled with ANSI escape sequences, which is the case when the standard
+     * output is a terminal.
+     * @return 'true' if the output supports colors, 'false' otherwise
+     */
+    bool Console::colorsEnabled() const {
+        return IO::out.colorsEnabled();
+    }
+
+    /**
+     * @brief Verifies if the input comes from a user, which is the case when the standard input is a terminal.
+     * @return 'true' if the input is interactive, 'false' otherwise (e.g. if it is a pipe or a file)
+     */
+    bool Console::interactive() {
+        return isatty(STDIN_FILENO);
+    }
+
+    /**
+     * @brief Writes the buffered output, which otherwise is only written before reading input and at exit.
+     */
+    void Console::flush() {
+        IO::out.flush();
+    }
+
+    /**
+     * @brief Reads a line of user input.
+     * @param instruction the instruction that will be displayed before prompting the user to input
+     * @param caseSensitive boolean indicating whether the input should be treated as case-sensitive
+     * @return read input
+     */
+    std::string Console::readInput(std::string_view instruction, bool caseSensitive) const {
+        std::string input = readLine(instruction);
+
+        // if the input is NOT case-sensitive, convert it to lowercase
+        if (!caseSensitive)
+            Utils::toLowercase(input);
+
+        return input;
+    }
+
+    /**
+     * @brief Reads user input.
+     * @param instruction the instruction that will be displayed before prompting the user to input
+     * @param options the options that will be displayed to the user
+     * @return read input
+     */
+    std::string Console::readInput(std::string_view instruction, const std::vector<std::string> &options) const {
+        // hash the options to achieve better search performance
+        uSet<std::string> options_(options.begin(), options.end());
+
+        for (;;) {
+            std::string line = readInput(instruction), input;
+            std::string_view word;
+
+            for (size_t pos = 0; Utils::nextToken(line, pos, word); ) {
+                input = word;
+
+                if (options_.find(input) != options_.end())
+                    return input;
+            }
+
+            IO::out << BREAK;
+            IO::out << RED << "Invalid command! Please, try again." << RESET << IO::endl;
+        }
+    }
+
+    /**
+     * @brief Reads the user's answer to a Yes/No question.
+     * @param instruction the instruction that will be displayed before prompting the user to input
+     * @param strict boolean indicating if the user must explicitly type Yes or No
+     * @return 'true' if the user answered Yes, 'false' otherwise
+     */
+    bool Console::readYesOrNo(std::string_view instruction, bool strict) const {
+        if (strict) {
+            std::string input = readInput(std::string(instruction) + YES_NO, {"yes", "no", "y", "n"});
+            return input == "yes" || input == "y";
+        }
+
+        // the answer is read into the line buffer, so no memory is allocated
+        readLine(instruction, YES_NO);
+        Utils::toLowercase(line);
+
+        return line == "yes" || line == "y";
+    }
+
+    /**
+     * @brief Reads a command, i.e. a line of user input whose words are turned into lowercase in place. No memory is
+     * allocated, as the words are views of the line buffer.
+     * @param instruction the instruction that will be displayed before prompting the user to input
+     * @param words array which will store the words, which are valid until the next line is read
+     * @param maxWords the capacity of the array
+     * @return the number of words of the command, up to maxWords, which is 0 if there is no more input
+     */
+    size_t Console::readCommand(std::string_view instruction, std::string_view *words, size_t maxWords) const {
+        readLine(instruction, "", true);
+        Utils::toLowercase(line);
+
+        size_t numWords = 0;
+        for (size_t pos = 0; numWords < maxWords && Utils::nextToken(line, pos, words[numWords]); ++numWords);
+
+        return numWords;
+    }
+
+    /**
+     * @brief Suggests the commands that are most similar to an unknown command (see CommandTrie::suggest()).
+     * @param words the words of the unknown command, in lowercase
+     * @param numWords the number of words
+     * @return a message with the suggestions (e.g. "Did you mean 'print graph stats'?"), which is valid until the
+     * next suggestion, or an empty view if there are none
+     */
+    std::string_view Console::suggestCommand(const std::string_view *words, size_t numWords) const {
+        CommandTrie::Suggestion suggestions[MAX_SUGGESTIONS];
+        size_t numSuggestions = commands.suggest(words, numWords, suggestions, MAX_SUGGESTIONS);
+
+        suggestion.clear();
+        if (!numSuggestions) return suggestion;
+
+        suggestion = "Did you mean ";
+
+        for (size_t i = 0; i < numSuggestions; ++i) {
+            if (i) suggestion += (i + 1 == numSuggestions) ? " or " : ", ";
+            ((suggestion += '\'') += suggestions[i].command) += '\'';
+        }
+
+        suggestion += '?';
+        return suggestion;
+    }
+
+    /**
+     * @brief Displays an error message, e.g. because the input is invalid.
+     * @param message the message
+     */
+    void Console::printError(std::string_view message) const {
+        IO::out << BREAK;
+        IO::out << RED << message << RESET << IO::endl;
+    }
+
+    /**
+     * @brief Displays the status of a job, e.g. "[1] run sorting algorithm: running (2.5 s)".
+     * @param job the job
+     */
+    void Console::printJob(const JobPool::Job &job) const {
+        auto end = job.finished() ? job.end : std::chrono::steady_clock::now();
+        long long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - job.start).count();
+
+        IO::out << '[' << job.id << "] " << job.name << ": " << JobPool::toString(job.state) << " ("
+            << elapsed / 1000 << '.' << elapsed / 100 % 10 << " s)";
+
+        if (!job.error.empty()) IO::out << ' ' << RED << job.error << RESET;
+        IO::out << IO::endl;
+    }
+
+    /**
+     * @brief Runs a command in the background, so the user can keep inputting commands while it runs. Its output is
+     * displayed when it finishes (see reportJobs()).
+     * @param name the name of the command, which must outlive the job
+     * @param task the function that executes the command, which receives the token that signals its cancellation
+     * @return the handle of the job
+     */
+    JobPool::Handle Console::submitJob(std::string_view name, std::function<void(const StopToken &)> task) {
+        JobPool::Handle job = jobs.submit(name, std::move(task));
+
+        IO::out << BREAK;
+        printJob(*job);
+
+        return job;
+    }
+
+    /**
+     * @brief Executes the built-in commands that manage the jobs, which are:
+     * - 'jobs', which lists the jobs that are running or whose end was not yet reported;
+     * - 'wait [id]', which waits for a job (or every job) to finish (pressing Ctrl-C meanwhile cancels it);
+     * - 'cancel [id]', which requests a job (or every job) to stop.
+     * @param words the words input, in lowercase
+     * @param numWords the number of words
+     * @return 'true' if the words form a built-in command, 'false' otherwise
+     */
+    bool Console::runJobCommand(const std::string_view *words, size_t numWords) {
+        if (!numWords) return false;
+
+        bool list = words[0] == "jobs";
+        if (numWords > (list ? 1 : 2) || (!list && words[0] != "wait" && words[0] != "cancel")) return false;
+
+        JobPool::Handle job;
+
+        if (numWords == 2) {
+            size_t id = 0;
+            auto [end, error] = std::from_chars(words[1].data(), words[1].data() + words[1].size(), id);
+
+            // the words may be a command that is not valid
+            if (error != std::errc() || end != words[1].data() + words[1].size()) return false;
+
+            if (!(job = jobs.find(id))) {
+                IO::out << BREAK;
+                IO::out << RED << "There is no job " << id << '!' << RESET << IO::endl;
+                return true;
+            }
+        }
+
+        if (list) {
+            IO::out << BREAK;
+            std::vector<JobPool::Handle> jobs_ = jobs.list();
+
+            if (jobs_.empty())
+                IO::out << "There are no jobs." << IO::endl;
+
+            for (const JobPool::Handle &job_ : jobs_)
+                printJob(*job_);
+
+            return true;
+        }
+
+        if (words[0] == "cancel") {
+            jobs.cancel(job);
+
+            IO::out << BREAK;
+            IO::out << (job ? "The job was asked to stop." : "Every job was asked to stop.") << IO::endl;
+        }
+        else jobs.wait(job);
+
+        reportJobs();
+        return true;
+    }
+
+    /**
+     * @brief Displays the jobs that finished since the last report, along with their output.
+     */
+    void Console::reportJobs() {
+        for (const JobPool::Handle &job : jobs.reap()) {
+            IO::out << BREAK;
+            printJob(*job);
+
+            if (job->output.empty()) continue;
+
+            IO::out << '\n' << job->output;
+            if (job->output.back() != '\n') IO::out << '\n';
+        }
+    }
+
+    /**
+     * @brief Cancels the jobs that are still running and waits for them to finish. This must be done before the
+     * object that submitted the jobs is destroyed, as the jobs may use it.
+     */
+    void Console::finishJobs() {
+        jobs.cancel();
+        jobs.wait();
+
+        reportJobs();
+    }
+
+    /**
+     * @brief Serves clients over a Unix domain socket until the program is interrupted (see Server). The input and
+     * output of the commands a client runs are redirected to the client.
+     * @param path the path to the socket
+     * @param numWorkers the number of workers that execute the commands, or 0 to use one per hardware thread
+     * @param handler the function that executes the lines the clients send
+     * @return the exit status of the program
+     */
+    int Console::serve(const char *path, unsigned numWorkers, Server::Handler handler) {
+        Server server(path, numWorkers, std::move(handler));
+        return server.run();
+    }
+
+    /**
+     * @brief Runs a session in the terminal, as usual, and saves its transcript (see Transcript). The output in the
+     * transcript is the output of replaying the input of the session, so it is what a replay must reproduce.
+     * @param path the path to the file where the transcript will be saved
+     * @param console the function that runs the console (e.g. creates an instance of the generated class and calls
+     * its run() method)
+     * @return the exit status of the program
+     */
+    int Console::recordSession(const char *path, const std::function<void()> &console) {
+        std::vector<std::string> input;
+
+        {
+            IO::Record record(input);
+            console();
+        }
+
+        Session session(std::move(input));
+        session.run(console);
+
+        if (!session.getTranscript().save(path)) {
+            IO::err << "Could not write the transcript to '" << path << "'!\n";
+            return EXIT_FAILURE;
+        }
+
+        IO::err << "The session was saved to '" << path << "'.\n";
+        return EXIT_SUCCESS;
+    }
+
+    /**
+     * @brief Replays the transcripts of sessions in parallel and verifies if their output is unchanged (see
+     * Replayer).
+     * @param path the path to a transcript, or to a directory whose files are transcripts
+     * @param numWorkers the number of threads that replay the sessions, or 0 to use one per hardware thread
+     * @param console the function that runs the console (e.g. creates an instance of the generated class and calls
+     * its run() method), which is called concurrently by the workers
+     * @return the exit status of the program
+     */
+    int Console::replaySessions(const char *path, unsigned numWorkers, const std::function<void()> &console) {
+        return Replayer(path).run(numWorkers, console);
+    }
+
+    /**
+     * @brief Benchmarks a command, i.e. executes it repeatedly with its output discarded, and displays its latency,
+     * throughput and heap allocations (see Benchmark).
+     * @param command the function that executes the command, which returns 'false' if the command does not exist
+     * @param iterations the number of executions that are measured, or 0 to measure as many as fit in about a second
+     * @return the number of times the command was executed, which is 0 if it does not exist
+     */
+    size_t Console::benchmark(const std::function<bool()> &command, size_t iterations) const {
+        Benchmark benchmark(iterations);
+        bool exists;
+
+        try {
+            exists = benchmark.run(command);
+        }
+        catch (const std::exception &e) {
+            printError((std::string) "The benchmark failed, as " + e.what() + '!');
+            return benchmark.executions();
+        }
+
+        if (!exists) return 0;
+
+        IO::out << BREAK;
+        IO::out << benchmark.report() << IO::endl;
+
+        return benchmark.executions();
+    }
+
+    /**
+     * @brief Executes the last line read by readCommand(), if it composes several commands (see CommandGraph). A
+     * stage with a single command runs on the calling thread, so the command can read input, whereas the commands of
+     * a stage that run in parallel are executed by a pool of workers, which is started the first time it is needed.
+     * @param resolve the function that resolves the words of a command (e.g. the resolveCommand() method of the
+     * generated class)
+     * @param execute the function that executes a command (e.g. calls the executeCommand() method of the generated
+     * class), which must be thread-safe
+     * @return 'true' if the line is a composition, even if it is invalid, 'false' otherwise
+     */
+    bool Console::runComposite(const CommandGraph::Resolver &resolve, const CommandGraph::Executor &execute) {
+        if (!CommandGraph::isComposite(line)) return false;
+
+        CommandGraph graph;
+
+        if (!graph.parse(line, resolve)) {
+            printError(graph.error() + '!');
+            return true;
+        }
+
+        for (size_t i = 0; i < graph.stages(); ++i) {
+            size_t numBranches;
+            const CommandGraph::Branch *branches = graph.stage(i, numBranches);
+
+            if (numBranches == 1) {
+                CommandGraph::run(*branches, execute);
+                continue;
+            }
+
+            if (!workers) workers = std::make_unique<WorkerPool>();
+
+            std::vector<CommandGraph::Outcome> outcomes = graph.runParallel(i, *workers, execute);
+
+            for (size_t j = 0; j < numBranches; ++j) {
+                IO::out << outcomes[j].output;
+
+                if (!outcomes[j].error.empty())
+                    printError("The command '" + std::string(branches[j].name) + "' failed, as " + outcomes[j].error + '!');
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Returns the entry point of a command that is built as a plugin, loading the plugin the first time one of
+     * its commands is executed (see PluginTable). If it cannot be loaded, the reason is displayed.
+     * @param plugins the dispatch table of the plugins
+     * @param command the index of the command
+     * @return the entry point, or nullptr if it could not be loaded
+     */
+    void *Console::resolvePlugin(PluginTable &plugins, size_t command) const {
+        try {
+            return plugins.get(command);
+        }
+        catch (const std::exception &e) {
+            printError((std::string) "The command could not be loaded, as " + e.what() + '!');
+            return nullptr;
+        }
+    }
+
+    /**
+     * @brief Reloads the plugins, so the plugins that were rebuilt take effect without restarting the program. The
+     * plugins are not reloaded while commands run in the background, as they may be running the code of a plugin.
+     * @param plugins the dispatch table of the plugins
+     */
+    void Console::reloadPlugins(PluginTable &plugins) const {
+        if (!jobs.idle()) {
+            printError("The plugins cannot be reloaded while jobs are running!");
+            return;
+        }
+
+        size_t numPlugins = plugins.reload();
+
+        IO::out << BREAK;
+        IO::out << "Reloaded " << numPlugins << (numPlugins == 1 ? " plugin." : " plugins.") << IO::endl;
+    }
+
+    /**
+     * @brief Executes a command marked as CACHED, whose output is cached (see ResultCache). If the output the command
+     * displays before reading its first line of input is cached, it is displayed instead, and so on for each line the
+     * user inputs, so the command is only executed once the user inputs a sequence of lines that was never input
+     * before. Then, it is fed the lines that were input, and its output is hidden until it reads the last of them.
+     * @param cache the cache
+     * @param name the name of the command
+     * @param command the function that executes the command
+     */
+    void Console::runCached(ResultCache &cache, std::string_view name, const std::function<void()> &command) const {
+        IO::Feed *outer = IO::Feed::current();
+        uint64_t key = ResultCache::hash(name);
+
+        std::vector<std::string> inputs;
+        std::string output;
+        bool final;
+
+        while (cache.find(key, output, final)) {
+            IO::out << output;
+            if (final) return;
+
+            inputs.push_back(readRawLine(outer));
+            key = ResultCache::hash(inputs.back(), key);
+        }
+
+        std::string teed, hidden;
+        std::optional<IO::Capture> capture;
+        if (!inputs.empty()) capture.emplace(hidden);
+
+        size_t mark = 0, numInputs = 0;
+        bool caching = true, ended = false;
+        key = ResultCache::hash(name);
+
+        auto source = [&](std::string &input) {
+            // the output displayed before the command reads a line is a segment, unless the line was input before, in
+            // which case it is already cached
+            if (caching && numInputs >= inputs.size())
+                caching = cache.insert(key, std::string_view(teed).substr(mark), false);
+
+            mark = teed.size();
+
+            if (numInputs < inputs.size()) {
+                input = inputs[numInputs++];
+                if (numInputs == inputs.size()) capture.reset();
+            }
+            else if ((input = readRawLine(outer)).empty()) {
+                ended = true;
+                return false;
+            }
+
+            key = ResultCache::hash(input, key);
+            return true;
+        };
+
+        try {
+            IO::Tee tee(teed);
+            IO::Feed feed(source);
+
+            command();
+        }
+        catch (...) {
+            // the command is abandoned if the input ends before it finishes
+            if (ended) return;
+            throw;
+        }
+
+        // the command did not read every line that was input before
+        if (capture) {
+            capture.reset();
+            IO::out << std::string_view(teed).substr(mark);
+        }
+
+        if (caching) cache.insert(key, std::string_view(teed).substr(mark), true);
+    }
+
+    /**
+     * @brief Displays an instruction and reads a line of user input into the line buffer (see readRawLine()).
+     * @param instruction the instruction that will be displayed before prompting the user to input
+     * @param suffix text that is displayed right after the instruction (e.g. the options)
+     * @param command boolean indicating if the line is a command, which can be completed and is saved in the history
+     * @return the line that was read, which is valid until the next line is read
+     */
+    const std::string &Console::readLine(std::string_view instruction, std::string_view suffix, bool command) const {
+        IO::out << BREAK;
+        IO::out << instruction << suffix << '\n' << IO::endl;
+
+        return readRawLine(IO::Feed::current(), command);
+    }
+
+    /**
+     * @brief Reads a line of user input into the line buffer, without displaying anything. Leading whitespace and
+     * blank lines are skipped. If the console is a terminal, the line is read with the line editor, whereas if the
+     * input is redirected (see IO::Feed), it is read from there. Otherwise, it is also recorded if the calling thread
+     * records its input (see IO::Record).
+     * @param feed the source the input of the calling thread is redirected to, or nullptr if it is not redirected
+     * @param command boolean indicating if the line is a command, which can be completed and is saved in the history
+     * @return the line that was read, which is valid until the next line is read
+     */
+    const std::string &Console::readRawLine(IO::Feed *feed, bool command) const {
+        TRACE_SCOPE("input");
+
+        // the clients of the server and the sessions that are replayed provide their own input
+        if (feed)
+            return line = feed->readLine();
+
+        line.clear();
+
+        if (editor.isEnabled()) {
+            IO::out.flush();
+            while (editor.readLine(line, command) && line.find_first_not_of(" \t") == std::string::npos);
+
+            line.erase(0, line.find_first_not_of(" \t"));
+        }
+        else {
+            IO::in.skipWhitespace();
+            IO::in.readLine(line);
+        }
+
+        if (std::vector<std::string> *recorded = IO::Record::current(); recorded && !line.empty())
+            recorded->push_back(line);
+
+        return line;
+    }
+
+    /**
+     * @brief Reads a number from the console. The first token of the input that is a number is accepted.
+     *
+     * The tokens are parsed in place, so no memory is allocated and no exceptions are thrown, even if the input
+     * contains many words.
+     * @param instruction the instruction that will be displayed before prompting the user to input the number
+     * @param base the base of integers
+     * @return the number input by the user
+     */
+    template <typename T>
+    T Console::readValue(std::string_view instruction, int base) const {
+        T number;
+
+        while (!Utils::parseFirstNumber(readLine(instruction), number, base)) {
+            printError("Invalid input! Please, try again.");
+        }
+
+        return number;
+    }
+
+    /**
+     * @brief Reads a number within a range from the console.
+     * @param instruction the instruction that will be displayed before prompting the user to input the number
+     * @param minimum the minimum accepted number
+     * @param maximum the maximum accepted number
+     * @param base the base of integers
+     * @return the number input by the user
+     */
+    template <typename T>
+    T Console::readValue(std::string_view instruction, T minimum, T maximum, int base) const {
+        T number;
+
+        for (;;) {
+            number = readValue<T>(instruction, base);
+
+            // verify if the number is within the specified range
+            if (number >= minimum && number <= maximum)
+                break;
+
+            printError("Invalid number! Please, try again.");
+        }
+
+        return number;
+    }
+
+    /**
+     * @brief Reads a number from the console.
+     * @param instruction the instruction that will be displayed before prompting the user to input the number
+     * @return the number input by the user
+     */
+    double Console::readNumber(std::string_view instruction) const {
+        return readValue<double>(instruction, 10);
+    }
+
+    /**
+     * @brief Reads a number from the console.
+     * @param instruction the instruction that will be displayed before prompting the user to input the number
+     * @param minimum the minimum accepted number
+     * @param maximum the maximum accepted number
+     * @return the number input by the user
+     */
+    double Console::readNumber(std::string_view instruction, double minimum, double maximum) const {
+        return readValue<double>(instruction, minimum, maximum, 10);
+    }
+
+    /**
+     * @brief Reads a number from the console.
+     * @param instruction the instruction that will be displayed before prompting the user to input the number
+     * @param options the options (numbers) that will be displayed to the user
+     * @return the number input by the user
+     */
+    double Console::readNumber(std::string_view instruction, const std::vector<double> &options) const {
+        double number;
+
+        // hash the options to achieve better search performance
+        uSet<double> options_(options.begin(), options.end());
+
+        for (;;) {
+            number = readNumber(instruction);
+
+            // verify if the number is one of the options
+            if (options_.find(number) != options_.end())
+                break;
+
+            printError("Invalid number! Please, try again.");
+        }
+
+        return number;
+    }
+
+    /**
+     * @brief Reads an integer from the console.
+     * @param instruction the instruction that will be displayed before prompting the user to input the integer
+     * @return the integer input by the user
+     */
+    long long Console::readInteger(std::string_view instruction) const {
+        return readValue<long long>(instruction, 10);
+    }
+
+    /**
+     * @brief Reads an integer from the console.
+     * @param instruction the instruction that will be displayed before prompting the user to input the integer
+     * @param minimum the minimum accepted integer
+     * @param maximum the maximum accepted integer
+     * @return the integer input by the user
+     */
+    long long Console::readInteger(std::string_view instruction, long long minimum, long long maximum) const {
+        return readValue<long long>(instruction, minimum, maximum, 10);
+    }
+
+    /**
+     * @brief Reads a non-negative integer from the console.
+     * @param instruction the instruction that will be displayed before prompting the user to input the integer
+     * @return the integer input by the user
+     */
+    unsigned long long Console::readUnsigned(std::string_view instruction) const {
+        return readValue<unsigned long long>(instruction, 10);
+    }
+
+    /**
+     * @brief Reads a non-negative integer from the console.
+     * @param instruction the instruction that will be displayed before prompting the user to input the integer
+     * @param minimum the minimum accepted integer
+     * @param maximum the maximum accepted integer
+     * @return the integer input by the user
+     */
+    unsigned long long Console::readUnsigned(std::string_view instruction, unsigned long long minimum,
+                                             unsigned long long maximum) const {
+        return readValue<unsigned long long>(instruction, minimum, maximum, 10);
+    }
+
+    /**
+     * @brief Reads a hexadecimal integer (with or without the prefix "0x") from the console.
+     * @param instruction the instruction that will be displayed before prompting the user to input the integer
+     * @return the integer input by the user
+     */
+    unsigned long long Console::readHex(std::string_view instruction) const {
+        return readValue<unsigned long long>(instruction, 16);
+    }
+
+    /**
+     * @brief Reads a hexadecimal integer (with or without the prefix "0x") from the console.
+     * @param instruction the instruction that will be displayed before prompting the user to input the integer
+     * @param minimum the minimum accepted integer
+     * @param maximum the maximum accepted integer
+     * @return the integer input by the user
+     */
+    unsigned long long Console::readHex(std::string_view instruction, unsigned long long minimum,
+                                        unsigned long long maximum) const {
+        return readValue<unsigned long long>(instruction, minimum, maximum, 16);
+    }
+
+    /**
+     * @brief Reads every number of a line of user input, in a single pass. Tokens that are not numbers are ignored.
+     * @param instruction the instruction that will be displayed before prompting the user to input the numbers
+     * @return the numbers input by the user
+     */
+    std::vector<double> Console::readNumbers(std::string_view instruction) const {
+        std::vector<double> numbers;
+
+        for (;;) {
+            Utils::parseNumbers(readLine(instruction), numbers);
+            if (!numbers.empty()) break;
+
+            IO::out << BREAK;
+            IO::out << RED << "Invalid input! Please, try again." << RESET << IO::endl;
+        }
+
+        return numbers;
+    }
+
+    /**
+     * @brief Reads a path from the console and verifies if it corresponds to a file.
+     * @param instruction the instruction that will be displayed before prompting the user to input the path
+     * @return the path input by the user
+     */
+    std::string Console::readFilename(std::string_view instruction) const {
+        std::string filename;
+
+        for (;;) {
+            std::string line = readInput(instruction, true);
+
+            for (size_t pos = 0; nextPath(line, pos, filename); ) {
+                // verify if the file exists
+                if (std::filesystem::is_regular_file(filename))
+                    return filename;
+            }
+
+            IO::out << BREAK;
+            IO::out << RED << "Invalid filename! Please, try again." << RESET << IO::endl;
+        }
+    }
+
+    /**
+     * @brief Reads a path from the console and verifies if it corresponds to a directory.
+     * @param instruction the instruction that will be displayed before prompting the user to input the path
+     * @return the path input by the user
+     */
+    std::string Console::readDirname(std::string_view instruction) const {
+        std::string dirname;
+
+        for (;;) {
+            std::string line = readInput(instruction, true);
+            bool valid = false;
+
+            for (size_t pos = 0; nextPath(line, pos, dirname); ) {
+                // verify if the directory exists
+                if (std::filesystem::is_directory(dirname)) {
+                    valid = true;
+                    break;
+                }
+            }
+
+            if (valid) break;
+
+            IO::out << BREAK;
+            IO::out << RED << "Invalid directory! Please, try again." << RESET << IO::endl;
+        }
+
+        // format the name of the directory
+        if (dirname.back() != '/')
+            dirname += '/';
+
+        return dirname;
+    }
+
+    /**
+     * @brief Reads and parses a line of user input containing comma-separated values.
+     * @param instruction the instruction that will be displayed before prompting the user to input
+     * @param delimiter the character that separates each value
+     * @return the values input by the user
+     */
+    std::vector<std::string> Console::readCSV(std::string_view instruction, char delimiter) const {
+        // separate the user input into values (which may be quoted)
+        return CSV::parseLine(readLine(instruction), delimiter);
+    }
+}
@@ -0,0 +1,395 @@
+#include "log.h"
+
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+// the number of messages the ring buffer holds, which must be a power of two
+#define LOG_CAPACITY (1 << 12)
+
+// the size a log file grows to before it is rotated, in bytes
+#define MAX_LOG_SIZE (16 << 20)
+
+// the number of rotated log files that are kept (e.g. helpy.log.1 to helpy.log.3)
+#define MAX_LOG_FILES 3
+
+// how long the background thread sleeps for when there are no messages, in milliseconds
+#define DRAIN_INTERVAL 10
+
+// the number of bytes of formatted messages that are written at once
+#define WRITE_SIZE (64 << 10)
+
+using Clock = std::chrono::system_clock;
+
+namespace HelpyRuntime::Utils {
+    /**
+     * @brief A slot of the ring buffer. Its sequence tells which position of the buffer it holds and whether the
+     * message in it was published, so the producers only need to agree on the next position (see Logger::claim()).
+     */
+    struct alignas(64) LogSlot {
+        std::atomic<uint64_t> sequence;
+        uint64_t position;
+        LogRecord record; // its header shares a cache line with the sequence
+    };
+
+    static_assert(sizeof(LogSlot) == 16 + LogRecord::SIZE);
+
+    static std::unique_ptr<LogSlot[]> slots;
+    static std::atomic<uint64_t> tail = 0; // the next position to be claimed by the threads that log
+    static std::atomic<uint64_t> head = 0; // the next position to be drained by the background thread
+    static std::atomic<uint64_t> numDropped = 0;
+    static std::atomic<uint32_t> numThreads = 0;
+
+    static std::mutex mutex; // serializes starting and stopping the logger
+    static std::thread drainer;
+    static std::atomic<bool> running = false;
+
+    static std::string path;
+    static int fd = -1;
+    static size_t fileSize = 0;
+
+    static TickConverter converter;
+    static Clock::time_point startTime;
+
+    static constexpr std::string_view LEVELS[] = {"debug", "info", "warning", "error"};
+
+    /**
+     * @brief Claims the next slot of the ring buffer, for the calling thread to write a message to.
+     * @return the record of the slot, or nullptr if the buffer is full
+     */
+    LogRecord *Logger::claim() {
+        if (!thread) thread = ++numThreads;
+
+        uint64_t position = tail.load(std::memory_order_relaxed);
+
+        for (;;) {
+            LogSlot &slot = slots[position & (LOG_CAPACITY - 1)];
+            auto difference = (int64_t) (slot.sequence.load(std::memory_order_acquire) - position);
+
+            if (!difference) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.position = position;
+                    return &slot.record;
+                }
+            }
+            else if (difference < 0) {
+                numDropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            else position = tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Publishes a message, so the background thread can write it.
+     * @param record the record of the slot that was claimed (see claim())
+     */
+    void Logger::publish(LogRecord *record) {
+        auto *slot = reinterpret_cast<LogSlot *>(reinterpret_cast<char *>(record) - offsetof(LogSlot, record));
+        slot->sequence.store(slot->position + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Appends a message of the log to a string, escaping the characters that would end its value.
+     * @param out the string
+     * @param text the text of the message
+     */
+    static void appendEscaped(std::string &out, std::string_view text) {
+        for (char c : text) {
+            if (c == '"' || c == '\\') (out += '\\') += c;
+            else if (c == '\n') out += "\\n";
+            else out += c;
+        }
+    }
+
+    /**
+     * @brief Appends the time a message was logged to a string, in UTC and in the ISO 8601 format with microseconds
+     * (e.g. 2024-05-01T12:34:56.123456Z).
+     * @param out the string
+     * @param ticks the time the message was logged, in ticks
+     * @param nanosecondsPerTick the duration of a tick
+     */
+    static void appendTime(std::string &out, uint64_t ticks, double nanosecondsPerTick) {
+        auto nanoseconds = (int64_t) ((double) (int64_t) (ticks - converter.origin()) * nanosecondsPerTick);
+        auto time = startTime + std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(nanoseconds));
+
+        long long microseconds = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+        std::time_t seconds = microseconds / 1000000;
+
+        std::tm calendar{};
+        gmtime_r(&seconds, &calendar);
+
+        char text[32];
+        snprintf(text, sizeof(text), "%04d-%02d-%02dT%02d:%02d:%02d.%06dZ", calendar.tm_year + 1900, calendar.tm_mon + 1,
+                 calendar.tm_mday, calendar.tm_hour, calendar.tm_min, calendar.tm_sec, (int) (microseconds % 1000000));
+
+        out += text;
+    }
+
+    /**
+     * @brief Appends the next argument of a message to a string.
+     * @param out the string
+     * @param args the arguments of the message that were not appended yet, which are advanced past the argument
+     */
+    static void appendArgument(std::string &out, const char *&args) {
+        char digits[32];
+        auto type = (LogRecord::Type) *args++;
+
+        switch (type) {
+            case LogRecord::Type::Signed : {
+                int64_t value;
+                memcpy(&value, args, sizeof(value));
+                args += sizeof(value);
+
+                out.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr - digits);
+                break;
+            }
+            case LogRecord::Type::Unsigned : {
+                uint64_t value;
+                memcpy(&value, args, sizeof(value));
+                args += sizeof(value);
+
+                out.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr - digits);
+                break;
+            }
+            case LogRecord::Type::Floating : {
+                double value;
+                memcpy(&value, args, sizeof(value));
+                args += sizeof(value);
+
+                out.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr - digits);
+                break;
+            }
+            case LogRecord::Type::Boolean :
+                out += *args++ ? "true" : "false";
+                break;
+            case LogRecord::Type::Character :
+                out += *args++;
+                break;
+            case LogRecord::Type::String : {
+                uint16_t length;
+                memcpy(&length, args, sizeof(length));
+
+                out.append(args + sizeof(length), length);
+                args += sizeof(length) + length;
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Formats a message as a line of the log, in the logfmt format (e.g. time=2024-05-01T12:34:56.123456Z
+     * level=info thread=1 msg="sorted 10 items").
+     * @param out the string the line is appended to
+     * @param record the message
+     * @param nanosecondsPerTick the duration of a tick
+     */
+    static void format(std::string &out, const LogRecord &record, double nanosecondsPerTick) {
+        out += "time=";
+        appendTime(out, record.ticks, nanosecondsPerTick);
+        ((out += " level=") += LEVELS[record.level]) += " thread=" + std::to_string(record.thread) + " msg=\"";
+
+        std::string message;
+        const char *args = record.args;
+        unsigned numArgs = record.numArgs;
+
+        for (const char *c = record.format; *c; ++c) {
+            if ((c[0] == '{' && c[1] == '{') || (c[0] == '}' && c[1] == '}')) {
+                message += *c++;
+                continue;
+            }
+
+            if (c[0] == '{' && c[1] == '}' && numArgs) {
+                appendArgument(message, args);
+                --numArgs;
+                ++c;
+                continue;
+            }
+
+            message += *c;
+        }
+
+        appendEscaped(out, message);
+        out += "\"\n";
+    }
+
+    /**
+     * @brief Opens the log file, which is created if it does not exist.
+     * @param truncate boolean indicating if the contents of the file are discarded
+     * @return 'true' if the file was opened, 'false' otherwise
+     */
+    static bool openFile(bool truncate) {
+        fd = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+
+        struct stat status{};
+        fileSize = (fd >= 0 && !fstat(fd, &status)) ? (size_t) status.st_size : 0;
+
+        return fd >= 0;
+    }
+
+    /**
+     * @brief Rotates the log files, i.e. renames the file to <path>.1, the previous <path>.1 to <path>.2 and so on,
+     * discarding the oldest file, and starts a new file.
+     */
+    static void rotate() {
+        close(fd);
+
+        for (int i = MAX_LOG_FILES - 1; i > 0; --i) {
+            std::string from = path + '.' + std::to_string(i);
+            rename(from.c_str(), (path + '.' + std::to_string(i + 1)).c_str());
+        }
+
+        rename(path.c_str(), (path + ".1").c_str());
+        openFile(true);
+    }
+
+    /**
+     * @brief Writes formatted messages to the log file, which is rotated first if it would grow too large.
+     * @param out the messages, which are cleared
+     */
+    static void writeFile(std::string &out) {
+        if (out.empty()) return;
+
+        if (fileSize && fileSize + out.size() > MAX_LOG_SIZE) rotate();
+
+        for (size_t written = 0; fd >= 0 && written < out.size(); ) {
+            ssize_t result = write(fd, out.data() + written, out.size() - written);
+            if (result <= 0) break;
+
+            written += result;
+        }
+
+        fileSize += out.size();
+        out.clear();
+    }
+
+    /**
+     * @brief Drains the ring buffer until the logger stops, writing the messages to the log file.
+     */
+    static void drain() {
+        std::string out;
+        uint64_t reported = 0; // the number of dropped messages that were reported
+
+        for (;;) {
+            // the messages published before the logger stopped are still written
+            bool stopping = !running.load(std::memory_order_acquire);
+            double nanosecondsPerTick = converter.nanosecondsPerTick();
+            size_t numDrained = 0;
+
+            uint64_t position = head.load(std::memory_order_relaxed);
+
+            for (;; ++position, ++numDrained) {
+                LogSlot &slot = slots[position & (LOG_CAPACITY - 1)];
+                if (slot.sequence.load(std::memory_order_acquire) != position + 1) break;
+
+                format(out, slot.record, nanosecondsPerTick);
+                slot.sequence.store(position + LOG_CAPACITY, std::memory_order_release);
+
+                if (out.size() >= WRITE_SIZE) writeFile(out);
+            }
+
+            if (uint64_t dropped = numDropped.load(std::memory_order_relaxed); dropped != reported) {
+                LogRecord record{readTicks(), "dropped {} messages, as the buffer was full", 0,
+                                 (uint8_t) Logger::Level::Warning, 0, 0, {}};
+
+                record.add(dropped - reported);
+                format(out, record, nanosecondsPerTick);
+
+                reported = dropped;
+            }
+
+            writeFile(out);
+            head.store(position, std::memory_order_release);
+
+            if (stopping) break;
+            if (!numDrained) std::this_thread::sleep_for(std::chrono::milliseconds(DRAIN_INTERVAL));
+        }
+    }
+
+    /**
+     * @brief Starts logging to a file. The messages are appended to the file, if it exists.
+     * @param path_ the path to the file
+     * @return 'true' if the file was opened, 'false' otherwise (e.g. if the logger is already running)
+     */
+    bool Logger::start(const char *path_) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (drainer.joinable()) return false;
+
+        path = path_;
+        if (!openFile(false)) return false;
+
+        // the buffer is kept once the logger stops, as threads that were logging at the time may still use it
+        if (!slots) slots = std::make_unique<LogSlot[]>(LOG_CAPACITY);
+
+        for (uint64_t i = 0; i < LOG_CAPACITY; ++i)
+            slots[i].sequence.store(head + i, std::memory_order_relaxed);
+
+        tail = head.load();
+
+        converter = TickConverter();
+        startTime = Clock::now();
+
+        running = true;
+        drainer = std::thread(drain);
+        enabled_ = true;
+
+        return true;
+    }
+
+    /**
+     * @brief Stops logging, once the messages that were logged are written to the file. Messages that are logged
+     * while the logger stops may be lost.
+     */
+    void Logger::stop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!drainer.joinable()) return;
+
+        enabled_ = false;
+        running.store(false, std::memory_order_release);
+        drainer.join();
+
+        close(fd);
+        fd = -1;
+    }
+
+    /**
+     * @brief Waits until the messages that were logged so far are written to the file, if the logger is running.
+     */
+    void Logger::flush() {
+        uint64_t position = tail.load(std::memory_order_relaxed);
+
+        while (enabled() && head.load(std::memory_order_acquire) < position)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    /**
+     * @brief Returns the number of messages that were dropped because the ring buffer was full.
+     * @return the number of messages
+     */
+    uint64_t Logger::dropped() {
+        return numDropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Starts logging if the HELPY_LOG environment variable is set and stops logging when the program ends.
+     */
+    static struct LogStarter {
+        LogStarter() {
+            if (const char *path_ = getenv("HELPY_LOG"); path_ && *path_)
+                Logger::start(path_);
+        }
+
+        ~LogStarter() {
+            Logger::stop();
+        }
+    } starter;
+}
@@ -0,0 +1,208 @@
+#ifndef HELPY_RUNTIME_LOG_H
+#define HELPY_RUNTIME_LOG_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "../utils/ticks.h"
+
+/*
+ * The levels of the log messages. Messages below HELPY_LOG_LEVEL are removed at compile time, along with the
+ * evaluation of their arguments.
+ */
+#define HELPY_LOG_LEVEL_DEBUG   0
+#define HELPY_LOG_LEVEL_INFO    1
+#define HELPY_LOG_LEVEL_WARNING 2
+#define HELPY_LOG_LEVEL_ERROR   3
+#define HELPY_LOG_LEVEL_OFF     4
+
+#ifndef HELPY_LOG_LEVEL
+#define HELPY_LOG_LEVEL HELPY_LOG_LEVEL_INFO
+#endif
+
+namespace HelpyRuntime::Utils {
+    /**
+     * @brief A log message whose arguments were not formatted yet. The arguments are stored in binary, each preceded
+     * by its type, and strings are truncated if they do not fit in the record.
+     */
+    struct LogRecord {
+        static constexpr size_t SIZE = 240; // so a slot of the ring buffer takes 4 cache lines
+
+        enum class Type : uint8_t { Signed, Unsigned, Floating, Boolean, Character, String };
+
+        uint64_t ticks; // the time the message was logged (see Utils::readTicks())
+        const char *format;
+        uint32_t thread;
+        uint8_t level;
+        uint8_t numArgs;
+        uint16_t size; // the number of bytes of the arguments
+        char args[SIZE - 24];
+
+        /**
+         * @brief Appends an argument to the record.
+         * @param value the argument
+         * @return 'true' if the argument fits in the record, 'false' otherwise
+         */
+        template <typename T>
+        bool add(const T &value) {
+            using U = std::decay_t<T>;
+
+            if constexpr (std::is_same_v<U, bool>)
+                return add(Type::Boolean, &value, 1);
+            else if constexpr (std::is_same_v<U, char>)
+                return add(Type::Character, &value, 1);
+            else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+                auto value_ = (int64_t) value;
+                return add(Type::Signed, &value_, sizeof(value_));
+            }
+            else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>) {
+                auto value_ = (uint64_t) value;
+                return add(Type::Unsigned, &value_, sizeof(value_));
+            }
+            else if constexpr (std::is_floating_point_v<U>) {
+                auto value_ = (double) value;
+                return add(Type::Floating, &value_, sizeof(value_));
+            }
+            else if constexpr (std::is_convertible_v<const U &, std::string_view>)
+                return addString(value);
+            else
+                static_assert(!sizeof(U), "the argument cannot be logged");
+        }
+
+    private:
+        /**
+         * @brief Appends an argument to the record.
+         * @param type the type of the argument
+         * @param data the bytes of the argument
+         * @param length the number of bytes
+         * @return 'true' if the argument fits in the record, 'false' otherwise
+         */
+        bool add(Type type, const void *data, size_t length) {
+            if (size + 1 + length > sizeof(args)) return false;
+
+            args[size] = (char) type;
+            memcpy(args + size + 1, data, length);
+            size += 1 + length;
+
+            ++numArgs;
+            return true;
+        }
+
+        bool addString(std::string_view text) {
+            if (size + 3 > sizeof(args)) return false;
+
+            auto length = (uint16_t) std::min(text.size(), sizeof(args) - size - 3);
+
+            args[size] = (char) Type::String;
+            memcpy(args + size + 1, &length, 2);
+            memcpy(args + size + 3, text.data(), length);
+            size += 3 + length;
+
+            ++numArgs;
+            return true;
+        }
+    };
+
+    /**
+     * @brief An asynchronous logger, which writes the log messages of every thread to a file, in the background.
+     *
+     * Logging a message only copies its format string (a pointer, as it must be a string literal) and its arguments
+     * to a ring buffer shared by every thread, which requires neither locks nor memory allocations. A background
+     * thread drains the buffer, formats the messages and appends them to the file, which is rotated once it grows
+     * too large. If the buffer is full, the messages are dropped, rather than blocking the thread that logs them, and
+     * the number of dropped messages is logged instead.
+     *
+     * Logging is disabled by default, in which case logging a message costs a single load. It is enabled if the
+     * HELPY_LOG environment variable is set, in which case the messages are written to the file it points to, or
+     * with start(). The messages are usually logged with the HELPY_LOG() macro, e.g.
+     * HELPY_LOG(INFO, "sorted {} items in {} ms", size, elapsed).
+     */
+    class Logger {
+    public:
+        enum class Level : uint8_t { Debug, Info, Warning, Error };
+
+    private:
+        static inline std::atomic<bool> enabled_ = false;
+        static inline thread_local uint32_t thread = 0; // the number of the calling thread, starting at 1
+
+    /* METHODS */
+    private:
+        static LogRecord *claim();
+        static void publish(LogRecord *record);
+
+    public:
+        /**
+         * @brief Verifies if logging is enabled.
+         * @return 'true' if the messages are being logged, 'false' otherwise
+         */
+        static bool enabled() {
+            return enabled_.load(std::memory_order_relaxed);
+        }
+
+        static bool start(const char *path);
+        static void stop();
+        static void flush();
+        static uint64_t dropped();
+
+        /**
+         * @brief Logs a message, if logging is enabled. The message is formatted by the background thread, in which
+         * each "{}" of the format string is replaced by the next argument ("{{" and "}}" stand for braces).
+         * @param level the level of the message
+         * @param format the format string, which must outlive the logger (e.g. a string literal)
+         * @param args the arguments, which may be numbers, booleans, characters or strings
+         */
+        template <typename... Args>
+        static void log(Level level, const char *format, const Args &...args) {
+            if (!enabled()) return;
+
+            LogRecord *record = claim();
+            if (!record) return;
+
+            record->ticks = readTicks();
+            record->format = format;
+            record->thread = thread;
+            record->level = (uint8_t) level;
+            record->numArgs = 0;
+            record->size = 0;
+
+            (void) (record->add(args) && ...);
+            publish(record);
+        }
+    };
+}
+
+#if HELPY_LOG_LEVEL <= HELPY_LOG_LEVEL_DEBUG
+#define HELPY_LOG_DEBUG(...) HelpyRuntime::Utils::Logger::log(HelpyRuntime::Utils::Logger::Level::Debug, __VA_ARGS__)
+#else
+#define HELPY_LOG_DEBUG(...) ((void) 0)
+#endif
+
+#if HELPY_LOG_LEVEL <= HELPY_LOG_LEVEL_INFO
+#define HELPY_LOG_INFO(...) HelpyRuntime::Utils::Logger::log(HelpyRuntime::Utils::Logger::Level::Info, __VA_ARGS__)
+#else
+#define HELPY_LOG_INFO(...) ((void) 0)
+#endif
+
+#if HELPY_LOG_LEVEL <= HELPY_LOG_LEVEL_WARNING
+#define HELPY_LOG_WARNING(...) HelpyRuntime::Utils::Logger::log(HelpyRuntime::Utils::Logger::Level::Warning, __VA_ARGS__)
+#else
+#define HELPY_LOG_WARNING(...) ((void) 0)
+#endif
+
+#if HELPY_LOG_LEVEL <= HELPY_LOG_LEVEL_ERROR
+#define HELPY_LOG_ERROR(...) HelpyRuntime::Utils::Logger::log(HelpyRuntime::Utils::Logger::Level::Error, __VA_ARGS__)
+#else
+#define HELPY_LOG_ERROR(...) ((void) 0)
+#endif
+
+/*
+ * Logs a message of a level (DEBUG, INFO, WARNING or ERROR), e.g. HELPY_LOG(INFO, "read {} lines", numLines).
+ */
+#define HELPY_LOG(level, ...) HELPY_LOG_##level(__VA_ARGS__)
+
+#endif //HELPY_RUNTIME_LOG_H
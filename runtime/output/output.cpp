@@ -0,0 +1,201 @@
+#include "output.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+
+#include "../io/io.h"
+
+// the size of the output buffer
+#define BUFFER_SIZE (1 << 16)
+
+namespace HelpyRuntime {
+    /**
+     * @brief Flushes the output, which is requested by the streams that are tied to it.
+     * @return 0
+     */
+    int Output::Flusher::sync() {
+        Output::flush();
+        return 0;
+    }
+
+    /**
+     * @brief Creates the output buffer and replaces the buffer of std::cout with it.
+     */
+    Output::Output() : buffer(BUFFER_SIZE), used(0), shared(false), sharers(0), escape(0), flushStream(&flusher) {
+        const char *noColor = getenv("NO_COLOR");
+        colored = isatty(STDOUT_FILENO) && !(noColor && *noColor);
+
+        setp(buffer.data(), buffer.data() + buffer.size());
+
+        std::cout.flush();
+        original = std::cout.rdbuf(this);
+
+        std::cin.tie(&flushStream);
+        std::cerr.tie(&flushStream);
+        IO::err.tie(Output::flush);
+    }
+
+    /**
+     * @brief Writes the remaining output and restores the original buffer of std::cout.
+     */
+    Output::~Output() {
+        write();
+
+        std::cout.rdbuf(original);
+        std::cin.tie(&std::cout);
+        std::cerr.tie(&std::cout);
+        IO::err.tie(nullptr);
+    }
+
+    /**
+     * @brief Returns the output buffer, which is created the first time this method is called and destroyed at exit.
+     * @return the output buffer
+     */
+    Output &Output::instance() {
+        static Output output;
+        return output;
+    }
+
+    /**
+     * @brief Writes the contents of the buffer to the standard output and empties the buffer.
+     */
+    void Output::write() {
+        size_t size = shared ? used : pptr() - pbase();
+        if (!colored) size = IO::stripEscapes(buffer.data(), size, escape);
+
+        for (const char *data = buffer.data(); size; ) {
+            ssize_t written = ::write(STDOUT_FILENO, data, size);
+
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+
+            data += written;
+            size -= written;
+        }
+
+        if (shared) used = 0;
+        else setp(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    /**
+     * @brief Empties the buffer when it is full.
+     * @param c the character that did not fit in the buffer
+     * @return the character, or EOF if the character is EOF
+     */
+    int Output::overflow(int c) {
+        if (shared) {
+            char c_ = (char) c;
+            if (c != traits_type::eof()) xsputn(&c_, 1);
+
+            return traits_type::not_eof(c);
+        }
+
+        write();
+        if (c == traits_type::eof()) return traits_type::not_eof(c);
+
+        *pptr() = (char) c;
+        pbump(1);
+
+        return c;
+    }
+
+    /**
+     * @brief Writes a sequence of characters. While the buffer is shared, every character is written by this method
+     * (or overflow()), so the output of the threads that capture it is redirected, and copied if they tee it.
+     * @param data the characters
+     * @param length the number of characters
+     * @return the number of characters written
+     */
+    std::streamsize Output::xsputn(const char *data, std::streamsize length) {
+        if (!shared) return std::streambuf::xsputn(data, length);
+
+        if (std::string *teed = IO::Tee::current())
+            teed->append(data, length);
+
+        if (std::string *captured = IO::Capture::current()) {
+            captured->append(data, length);
+            return length;
+        }
+
+        for (std::streamsize left = length; left; ) {
+            if (used == buffer.size()) write();
+
+            size_t chunk = std::min((size_t) left, buffer.size() - used);
+            std::memcpy(buffer.data() + used, data, chunk);
+
+            used += chunk;
+            data += chunk;
+            left -= (std::streamsize) chunk;
+        }
+
+        return length;
+    }
+
+    /**
+     * @brief Ignores the flushes requested by std::endl and std::flush. Use Output::flush() to flush the output.
+     * @return 0
+     */
+    int Output::sync() {
+        return 0;
+    }
+
+    /**
+     * @brief Buffers the standard output, if it is not already buffered.
+     */
+    void Output::install() {
+        instance();
+    }
+
+    /**
+     * @brief Writes the buffered output.
+     */
+    void Output::flush() {
+        // the buffer belongs to the threads whose output is not captured
+        if (IO::Capture::current()) return;
+
+        instance().write();
+    }
+
+    /**
+     * @brief Shares the buffer with the threads that capture their output, or stops sharing it. This must be done by
+     * the thread that reads input, before those threads start and after they finish writing, respectively.
+     *
+     * The calls nest, i.e. the buffer is shared until every call that shares it is matched by a call that stops
+     * sharing it, so the consoles that run in parallel (e.g. replayed sessions) do not stop sharing it for each other.
+     * While the buffer is shared, the characters are not written directly to it, which is slightly slower.
+     * @param shared boolean indicating if the buffer should be shared
+     */
+    void Output::share(bool shared) {
+        Output &output = instance();
+
+        if (shared) {
+            if (output.sharers++) return; // the buffer is already shared
+        }
+        else if (!output.sharers || --output.sharers) return; // the buffer is not shared, or is still shared
+
+        if (shared) {
+            output.used = output.pptr() - output.pbase();
+            output.setp(nullptr, nullptr);
+        }
+        else {
+            output.setp(output.buffer.data(), output.buffer.data() + output.buffer.size());
+            output.pbump((int) output.used);
+        }
+
+        output.shared = shared;
+    }
+
+    /**
+     * @brief Verifies if the output can be styled with ANSI escape sequences.
+     * @return 'true' if the output supports colors, 'false' otherwise
+     */
+    bool Output::colorsEnabled() {
+        return instance().colored;
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef HELPY_RUNTIME_OUTPUT_H
+#define HELPY_RUNTIME_OUTPUT_H
+
+#include <atomic>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+namespace HelpyRuntime {
+    /**
+     * @brief The buffer of the standard output.
+     *
+     * Once installed, everything written to std::cout is accumulated in a large buffer, which is only written to
+     * the standard output when it is full, before the program blocks on input (std::cin), before anything is written
+     * to std::cerr, when Output::flush() is called, and at exit. In particular, std::endl and std::flush no longer
+     * cause a write, so commands that print in loops are not bottlenecked on system calls.
+     *
+     * When the standard output is not a terminal, or the NO_COLOR environment variable is set, ANSI escape sequences
+     * are removed from the output. Anything written to IO::err (e.g. by ScriptReport) also flushes the buffer first.
+     *
+     * While commands run in the background, the buffer is shared (see share()), so the output of the threads that
+     * capture it (see IO::Capture) can be redirected, and the output of the threads that tee it (see IO::Tee) copied.
+     */
+    class Output : public std::streambuf {
+        /**
+         * @brief The buffer of the stream that std::cin and std::cerr are tied to, which flushes the output.
+         */
+        struct Flusher : public std::streambuf {
+            int sync() override;
+        };
+
+        std::vector<char> buffer;
+        size_t used; // the size of the output in the buffer while it is shared
+        std::streambuf *original;
+        bool colored, shared;
+        std::atomic<unsigned> sharers; // the number of times the buffer was shared and not yet unshared
+        int escape;
+
+        Flusher flusher;
+        std::ostream flushStream;
+
+    /* CONSTRUCTOR */
+    private:
+        Output();
+
+    public:
+        Output(const Output &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~Output() override;
+
+    /* METHODS */
+    private:
+        static Output &instance();
+        void write();
+
+    protected:
+        int overflow(int c) override;
+        std::streamsize xsputn(const char *data, std::streamsize length) override;
+        int sync() override;
+
+    public:
+        static void install();
+        static void flush();
+        static void share(bool shared);
+        [[nodiscard]] static bool colorsEnabled();
+    };
+}
+
+#endif //HELPY_RUNTIME_OUTPUT_H
@@ -0,0 +1,121 @@
+#include "plugin.h"
+
+#include <cstdlib>
+#include <dlfcn.h>
+#include <filesystem>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace HelpyRuntime {
+    /**
+     * @brief Creates the dispatch table. No plugin is loaded until one of its commands is executed.
+     * @param symbols the plugin and the entry point of each command, indexed by command
+     * @param numSymbols the number of commands
+     */
+    PluginTable::PluginTable(const Symbol *symbols, size_t numSymbols)
+        : symbols(symbols), numSymbols(numSymbols), functions(std::make_unique<std::atomic<void *>[]>(numSymbols)),
+          generation(0) {
+        const char *directory_ = getenv("HELPY_PLUGINS");
+
+        if (directory_ && *directory_) {
+            directory = directory_;
+            return;
+        }
+
+        std::error_code error;
+        std::filesystem::path executable = std::filesystem::read_symlink("/proc/self/exe", error);
+
+        directory = error ? "." : executable.parent_path().string();
+    }
+
+    /**
+     * @brief Unloads the plugins.
+     */
+    PluginTable::~PluginTable() {
+        for (const auto &[library, handle] : handles)
+            dlclose(handle);
+    }
+
+    /**
+     * @brief Loads a plugin, unless it is already loaded. Once the plugins were reloaded, each plugin is loaded from
+     * a temporary copy, as the dynamic linker would return its previous version if it could not be unloaded.
+     * @param library the name of the plugin
+     * @return the handle of the plugin
+     * @throws std::runtime_error if the plugin cannot be loaded
+     */
+    void *PluginTable::open(std::string_view library) {
+        if (auto it = handles.find(library); it != handles.end())
+            return it->second;
+
+        std::string path = directory + '/' + std::string(library) + ".so";
+        std::string copy;
+
+        if (generation) {
+            copy = (std::filesystem::temp_directory_path() / (std::string(library) + '_' + std::to_string(getpid())
+                + '_' + std::to_string(generation) + ".so")).string();
+
+            std::error_code error;
+            std::filesystem::copy_file(path, copy, std::filesystem::copy_options::overwrite_existing, error);
+
+            if (error)
+                throw std::runtime_error("the plugin '" + path + "' could not be copied (" + error.message() + ")");
+        }
+
+        // the symbols are resolved at once, so a plugin that is missing symbols fails to load instead of crashing
+        void *handle = dlopen((copy.empty() ? path : copy).c_str(), RTLD_NOW | RTLD_LOCAL);
+
+        // the copy stays mapped, so it is no longer needed
+        if (!copy.empty()) unlink(copy.c_str());
+
+        if (!handle)
+            throw std::runtime_error(dlerror());
+
+        handles.emplace(library, handle);
+        return handle;
+    }
+
+    /**
+     * @brief Resolves the entry point of a command, loading its plugin if needed, and caches it in the table.
+     * @param command the index of the command
+     * @return the entry point
+     * @throws std::runtime_error if the plugin or the entry point cannot be loaded
+     */
+    void *PluginTable::load(size_t command) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // another thread may have resolved it in the meantime
+        if (void *function = functions[command].load(std::memory_order_relaxed))
+            return function;
+
+        const Symbol &symbol = symbols[command];
+        void *function = dlsym(open(symbol.library), symbol.name);
+
+        if (!function)
+            throw std::runtime_error(dlerror());
+
+        functions[command].store(function, std::memory_order_release);
+        return function;
+    }
+
+    /**
+     * @brief Unloads the plugins, which are loaded again when their commands are executed, so the plugins that were
+     * rebuilt take effect. No command of a plugin may be running.
+     * @return the number of plugins that were unloaded
+     */
+    size_t PluginTable::reload() {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (size_t i = 0; i < numSymbols; ++i)
+            functions[i].store(nullptr, std::memory_order_relaxed);
+
+        for (const auto &[library, handle] : handles)
+            dlclose(handle);
+
+        size_t numPlugins = handles.size();
+
+        handles.clear();
+        ++generation;
+
+        return numPlugins;
+    }
+}
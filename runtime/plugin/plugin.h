@@ -0,0 +1,76 @@
+#ifndef HELPY_RUNTIME_PLUGIN_H
+#define HELPY_RUNTIME_PLUGIN_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// marks the entry points of a plugin, which is compiled with hidden visibility, so the executable can resolve them
+#define HELPY_PLUGIN_EXPORT __attribute__((visibility("default")))
+
+namespace HelpyRuntime {
+    /**
+     * @brief The dispatch table of the commands that are built as plugins (helpy run --plugins), i.e. shared objects
+     * that are only loaded when one of their commands is first executed, so the startup of the program does not
+     * depend on the number of commands.
+     *
+     * The entry point of each command is resolved once, when it is first executed, and cached in the table, so the
+     * following executions only cost an atomic load and an indirect call. The plugins are loaded from the directory
+     * of the executable, unless the HELPY_PLUGINS environment variable points to another directory, and they resolve
+     * the symbols of the runtime against the executable, which must export them.
+     *
+     * The plugins can be reloaded (e.g. after they are rebuilt) without restarting the program. The code of a plugin
+     * that cannot be unloaded (e.g. because it defines unique symbols) stays in memory, but its new version is loaded
+     * from a copy, so it is used anyway.
+     */
+    class PluginTable {
+    public:
+        struct Symbol {
+            const char *library; // the name of the plugin, without the extension
+            const char *name; // the name of the entry point of the command
+        };
+
+    private:
+        const Symbol *symbols;
+        size_t numSymbols;
+        std::unique_ptr<std::atomic<void *>[]> functions; // the entry points that were resolved, by command
+        std::string directory;
+        std::unordered_map<std::string_view, void *> handles; // the plugins that are loaded, by name
+        unsigned generation; // the number of times the plugins were reloaded
+        std::mutex mutex;
+
+    /* CONSTRUCTOR */
+    public:
+        PluginTable(const Symbol *symbols, size_t numSymbols);
+        PluginTable(const PluginTable &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~PluginTable();
+
+    /* METHODS */
+    private:
+        void *open(std::string_view library);
+        void *load(size_t command);
+
+    public:
+        /**
+         * @brief Returns the entry point of a command, loading its plugin if needed.
+         * @param command the index of the command
+         * @return the entry point, which must be cast to its type
+         * @throws std::runtime_error if the plugin or the entry point cannot be loaded
+         */
+        void *get(size_t command) {
+            void *function = functions[command].load(std::memory_order_acquire);
+            return function ? function : load(command);
+        }
+
+        size_t reload();
+    };
+}
+
+#endif //HELPY_RUNTIME_PLUGIN_H
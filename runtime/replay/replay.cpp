@@ -0,0 +1,319 @@
+#include "replay.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include "../io/io.h"
+#include "../server/server.h"
+
+// the maximum number of failed sessions that are reported in detail
+#define MAX_REPORTED_FAILURES 10
+
+using Clock = std::chrono::steady_clock;
+
+namespace HelpyRuntime {
+    /**
+     * @brief Creates an empty transcript.
+     */
+    Transcript::Transcript() : lineStart(true), state(0) {}
+
+    /**
+     * @brief Ends the last line of output, if it does not end with a newline.
+     */
+    void Transcript::endLine() {
+        if (!lineStart) text += '\n';
+        lineStart = true;
+    }
+
+    /**
+     * @brief Adds output to the transcript.
+     * @param output the output, which is emptied
+     */
+    void Transcript::addOutput(std::string &output) {
+        output.resize(IO::stripEscapes(output.data(), output.size(), state));
+
+        for (char c : output) {
+            // blank lines are saved without trailing whitespace, which editors tend to remove
+            if (lineStart) text += (c == '\n') ? "|" : "| ";
+
+            text += c;
+            lineStart = c == '\n';
+        }
+
+        output.clear();
+    }
+
+    /**
+     * @brief Adds a line of input to the transcript.
+     * @param line the line
+     */
+    void Transcript::addInput(std::string_view line) {
+        endLine();
+
+        ((text += "> ") += line) += '\n';
+        inputs.emplace_back(line);
+    }
+
+    /**
+     * @brief Ends the transcript, once the session ends.
+     */
+    void Transcript::finish() {
+        endLine();
+    }
+
+    /**
+     * @brief Returns the lines that were input.
+     * @return the lines
+     */
+    const std::vector<std::string> &Transcript::getInputs() const {
+        return inputs;
+    }
+
+    /**
+     * @brief Returns the transcript as text.
+     * @return the text
+     */
+    const std::string &Transcript::getText() const {
+        return text;
+    }
+
+    /**
+     * @brief Saves the transcript to a file.
+     * @param path the path to the file
+     * @return 'true' if the file was written, 'false' otherwise
+     */
+    bool Transcript::save(const char *path) const {
+        std::ofstream file(path);
+        return (file << text) && file.flush();
+    }
+
+    /**
+     * @brief Loads a transcript from a file.
+     * @param path the path to the file
+     * @return 'true' if the file is a transcript, 'false' otherwise
+     */
+    bool Transcript::load(const char *path) {
+        std::ifstream file(path);
+        if (!file.is_open()) return false;
+
+        std::ostringstream contents;
+        contents << file.rdbuf();
+
+        text = contents.str();
+        inputs.clear();
+
+        if (!text.empty() && text.back() != '\n') text += '\n';
+
+        for (size_t begin = 0, end; begin < text.size(); begin = end + 1) {
+            end = text.find('\n', begin);
+            std::string_view line(text.data() + begin, end - begin);
+
+            if (!line.compare(0, 2, "> "))
+                inputs.emplace_back(line.substr(2));
+            else if (line != "|" && line.compare(0, 2, "| "))
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Creates a session.
+     * @param input the lines that will be input, in order
+     */
+    Session::Session(std::vector<std::string> input) : input(std::move(input)), next(0), finished(false) {}
+
+    /**
+     * @brief Runs a console in the session. The session ends when the console returns or when it needs more input
+     * than the session has, in which case the error is added to the output.
+     * @param console the function that runs the console (e.g. creates an instance of the generated class and calls
+     * its run() method)
+     */
+    void Session::run(const std::function<void()> &console) {
+        {
+            IO::Capture capture(output);
+
+            IO::Feed feed([this](std::string &line) {
+                transcript.addOutput(output);
+                if (next == input.size()) return false;
+
+                line = input[next++];
+                transcript.addInput(line);
+
+                return true;
+            });
+
+            try {
+                console();
+                finished = true;
+            }
+            catch (const std::exception &e) {
+                ((output += "Error: ") += e.what()) += '\n';
+            }
+        }
+
+        transcript.addOutput(output);
+        transcript.finish();
+    }
+
+    /**
+     * @brief Verifies if the console returned before its input ended.
+     * @return 'true' if the console returned, 'false' otherwise
+     */
+    bool Session::isFinished() const {
+        return finished;
+    }
+
+    /**
+     * @brief Returns the transcript of the session, i.e. its input and output so far.
+     * @return the transcript
+     */
+    const Transcript &Session::getTranscript() const {
+        return transcript;
+    }
+
+    /**
+     * @brief Loads the transcripts to replay.
+     * @param path the path to a transcript, or to a directory whose files are transcripts
+     */
+    Replayer::Replayer(const char *path) : numInvalid(0) {
+        std::error_code error;
+
+        if (std::filesystem::is_directory(path, error)) {
+            for (const auto &entry : std::filesystem::directory_iterator(path, error)) {
+                if (entry.is_regular_file(error)) paths.push_back(entry.path().string());
+            }
+
+            // the sessions are reported in a predictable order
+            std::sort(paths.begin(), paths.end());
+        }
+        else paths.emplace_back(path);
+
+        // the files that are not transcripts are reported and skipped
+        size_t numValid = 0;
+        transcripts.resize(paths.size());
+
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (!transcripts[numValid].load(paths[i].c_str())) {
+                IO::err << "Could not read the transcript '" << paths[i] << "'!\n";
+                ++numInvalid;
+
+                continue;
+            }
+
+            if (numValid != i) paths[numValid] = std::move(paths[i]);
+            ++numValid;
+        }
+
+        paths.resize(numValid);
+        transcripts.resize(numValid);
+    }
+
+    /**
+     * @brief Writes a number with a fixed number of decimal places to the standard error.
+     * @param number the number
+     * @param precision the number of decimal places
+     */
+    static void writeFixed(double number, int precision) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), number, std::chars_format::fixed, precision);
+
+        IO::err << std::string_view(digits, result.ptr - digits);
+    }
+
+    /**
+     * @brief Finds the first line in which two texts differ.
+     * @param expected the first text
+     * @param actual the second text
+     * @param number variable which will store the number of the line, starting at 1
+     * @return the lines of both texts, which are empty if the text ended
+     */
+    static std::pair<std::string_view, std::string_view> firstDifference(std::string_view expected,
+                                                                         std::string_view actual, size_t &number) {
+        auto mismatch = std::mismatch(expected.begin(), expected.end(), actual.begin(), actual.end());
+        size_t pos = mismatch.first - expected.begin();
+
+        size_t begin = expected.rfind('\n', pos ? pos - 1 : 0);
+        begin = (begin == std::string_view::npos || !pos) ? 0 : begin + 1;
+        number = std::count(expected.begin(), expected.begin() + (long) begin, '\n') + 1;
+
+        auto line = [begin](std::string_view text) {
+            if (begin >= text.size()) return std::string_view();
+            return text.substr(begin, text.find('\n', begin) - begin);
+        };
+
+        return {line(expected), line(actual)};
+    }
+
+    /**
+     * @brief Replays every transcript, each with an instance of the console of its own, and reports the sessions
+     * whose output changed.
+     * @param numWorkers the number of threads that replay the sessions, or 0 to use one per hardware thread
+     * @param console the function that runs the console (e.g. creates an instance of the generated class and calls
+     * its run() method), which is called concurrently by the workers
+     * @return the exit status of the program, which signals failure if any session changed
+     */
+    int Replayer::run(unsigned numWorkers, const std::function<void()> &console) {
+        std::vector<std::string> actual(transcripts.size());
+        size_t numInputs = 0, numWorkers_;
+
+        auto start = Clock::now();
+
+        {
+            WorkerPool workers(numWorkers);
+            numWorkers_ = workers.size();
+
+            for (size_t i = 0; i < transcripts.size(); ++i) {
+                numInputs += transcripts[i].getInputs().size();
+
+                workers.submit([this, &actual, &console, i] {
+                    Session session(transcripts[i].getInputs());
+                    session.run(console);
+
+                    actual[i] = session.getTranscript().getText();
+                });
+            }
+        }
+
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        size_t numFailed = 0;
+
+        for (size_t i = 0; i < transcripts.size(); ++i) {
+            const std::string &expected = transcripts[i].getText();
+            if (actual[i] == expected) continue;
+
+            if (++numFailed > MAX_REPORTED_FAILURES) continue;
+
+            size_t number;
+            auto [expectedLine, actualLine] = firstDifference(expected, actual[i], number);
+
+            IO::err << paths[i] << ':' << number << ": the output changed\n"
+                    << "  expected: " << expectedLine << '\n'
+                    << "  actual:   " << actualLine << '\n';
+        }
+
+        if (numFailed > MAX_REPORTED_FAILURES)
+            IO::err << "... and " << numFailed - MAX_REPORTED_FAILURES << " more\n";
+
+        numFailed += numInvalid;
+
+        IO::err << "Replayed " << transcripts.size() << " sessions (" << numInputs << " inputs) in ";
+        writeFixed(seconds * 1e3, 3);
+        IO::err << " ms with " << numWorkers_ << " workers";
+
+        if (seconds > 0) {
+            IO::err << " (";
+            writeFixed((double) transcripts.size() / seconds, 0);
+            IO::err << " sessions/s)";
+        }
+
+        IO::err << ": " << numFailed << " failed\n";
+        return numFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef HELPY_RUNTIME_REPLAY_H
+#define HELPY_RUNTIME_REPLAY_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace HelpyRuntime {
+    /**
+     * @brief The lines that were input in a session and the output they produced, in the order they happened. It is
+     * saved as text, in which each line of output is preceded by "| " and each line of input by "> ", so it can be
+     * reviewed (and edited) by hand. The output is saved without ANSI escape sequences.
+     */
+    class Transcript {
+        std::vector<std::string> inputs;
+        std::string text;
+        bool lineStart; // whether the next character of output starts a line
+        int state; // the state of the removal of escape sequences, which may span several pieces of output
+
+    /* CONSTRUCTOR */
+    public:
+        Transcript();
+
+    /* METHODS */
+    private:
+        void endLine();
+
+    public:
+        void addOutput(std::string &output);
+        void addInput(std::string_view line);
+        void finish();
+        [[nodiscard]] const std::vector<std::string> &getInputs() const;
+        [[nodiscard]] const std::string &getText() const;
+        [[nodiscard]] bool save(const char *path) const;
+        bool load(const char *path);
+    };
+
+    /**
+     * @brief The input and output of a session of a console that does not use the terminal. While the session runs,
+     * the console reads its input from the session and writes its output to it (see IO::Feed and IO::Capture), so
+     * many sessions can run at once, in different threads, each with an instance of the console of its own.
+     */
+    class Session {
+        std::vector<std::string> input;
+        size_t next; // the index of the next line of input
+        std::string output; // the output that was not yet added to the transcript
+        Transcript transcript;
+        bool finished;
+
+    /* CONSTRUCTOR */
+    public:
+        explicit Session(std::vector<std::string> input);
+
+    /* METHODS */
+    public:
+        void run(const std::function<void()> &console);
+        [[nodiscard]] bool isFinished() const;
+        [[nodiscard]] const Transcript &getTranscript() const;
+    };
+
+    /**
+     * @brief Replays the transcripts of sessions in parallel, with no terminal I/O, and verifies if each session
+     * still produces the output in its transcript, which makes the transcripts a regression (and performance) suite.
+     */
+    class Replayer {
+        std::vector<std::string> paths;
+        std::vector<Transcript> transcripts;
+        size_t numInvalid; // the number of files that are not transcripts
+
+    /* CONSTRUCTOR */
+    public:
+        explicit Replayer(const char *path);
+
+    /* METHODS */
+    public:
+        int run(unsigned numWorkers, const std::function<void()> &console);
+    };
+}
+
+#endif //HELPY_RUNTIME_REPLAY_H
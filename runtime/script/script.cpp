@@ -0,0 +1,242 @@
+#include "script.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../io/io.h"
+
+// the size of the blocks in which scripts that cannot be mapped into memory are read
+#define BLOCK_SIZE (1 << 16)
+
+namespace HelpyRuntime {
+    /**
+     * @brief Opens a script.
+     * @param path the path to the script, or nullptr to read the script from the standard input
+     */
+    Script::Script(const char *path)
+        : fd(path ? open(path, O_RDONLY) : STDIN_FILENO), mapped(false), eof(false), data(nullptr), begin(0), end(0) {
+        if (fd < 0) return;
+
+        struct stat info{};
+
+        // map regular files into memory
+        if (!fstat(fd, &info) && S_ISREG(info.st_mode) && info.st_size > 0) {
+            void *map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (map != MAP_FAILED) {
+                madvise(map, info.st_size, MADV_SEQUENTIAL);
+
+                data = (const char *) map;
+                end = info.st_size;
+                mapped = eof = true;
+
+                return;
+            }
+        }
+
+        buffer.resize(BLOCK_SIZE);
+        data = buffer.data();
+    }
+
+    /**
+     * @brief Closes the script.
+     */
+    Script::~Script() {
+        if (mapped) munmap((void *) data, end);
+        if (fd > STDIN_FILENO) close(fd);
+    }
+
+    /**
+     * @brief Reads the next block of the script into the buffer, preserving the line that is currently being read.
+     * @return 'true' if any data was read, 'false' otherwise
+     */
+    bool Script::fill() {
+        if (eof) return false;
+
+        // move the incomplete line to the front of the buffer
+        std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+
+        if (end == buffer.size())
+            buffer.resize(buffer.size() * 2);
+
+        data = buffer.data();
+
+        ssize_t size;
+        while ((size = read(fd, buffer.data() + end, buffer.size() - end)) < 0 && errno == EINTR);
+
+        if (size <= 0) {
+            eof = true;
+            return false;
+        }
+
+        end += size;
+        return true;
+    }
+
+    /**
+     * @brief Verifies if the script was successfully opened.
+     * @return 'true' if the script is open, 'false' otherwise
+     */
+    bool Script::isOpen() const {
+        return fd >= 0;
+    }
+
+    /**
+     * @brief Reads the next line of the script.
+     * @param line view which will store the line, without the line terminator, and remains valid until the next call
+     * @return 'true' if a line was read, 'false' if the end of the script was reached
+     */
+    bool Script::nextLine(std::string_view &line) {
+        const char *newline;
+
+        while (!(newline = (const char *) std::memchr(data + begin, '\n', end - begin))) {
+            if (fill()) continue;
+
+            // last line, which lacks a line terminator
+            if (begin == end) return false;
+
+            newline = data + end;
+            break;
+        }
+
+        line = std::string_view(data + begin, newline - (data + begin));
+        begin = std::min((size_t) (newline - data) + 1, end);
+
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+
+        return true;
+    }
+
+    /**
+     * @brief Splits a line into words, which are separated by whitespace. Lines starting with '#' are comments.
+     * @param line the line to be split
+     * @param words array which will store the words
+     * @param maxWords the capacity of the array
+     * @return the number of words of the line, up to maxWords
+     */
+    size_t Script::split(std::string_view line, std::string_view *words, size_t maxWords) {
+        size_t numWords = 0, i = 0;
+
+        while (numWords < maxWords) {
+            while (i < line.size() && isspace((unsigned char) line[i])) ++i;
+            if (i == line.size() || (!numWords && line[i] == '#')) break;
+
+            size_t start = i;
+            while (i < line.size() && !isspace((unsigned char) line[i])) ++i;
+
+            words[numWords++] = line.substr(start, i - start);
+        }
+
+        return numWords;
+    }
+
+    /**
+     * @brief Creates the report of the execution of a script.
+     * @param names the names of the commands, indexed by command
+     * @param numCommands the number of commands
+     * @param timings boolean indicating if the execution time of each command should be measured
+     */
+    ScriptReport::ScriptReport(const std::string_view *names, size_t numCommands, bool timings)
+        : names(names), timings(timings), executed(0), failed(0), startTime(Clock::now()) {
+        if (!timings) return;
+
+        counts.resize(numCommands);
+        nanoseconds.resize(numCommands);
+    }
+
+    /**
+     * @brief Reports an invalid line of the script.
+     * @param lineNumber the number of the line
+     * @param line the contents of the line
+     * @param suggestion the commands which are similar to the line, if any
+     */
+    void ScriptReport::fail(size_t lineNumber, std::string_view line, std::string_view suggestion) {
+        ++failed;
+        IO::err << "Line " << lineNumber << ": Invalid command '" << line << "'!";
+
+        if (!suggestion.empty()) IO::err << ' ' << suggestion;
+        IO::err << '\n';
+    }
+
+    /**
+     * @brief Returns the number of invalid lines of the script.
+     * @return number of invalid lines
+     */
+    uint64_t ScriptReport::failures() const {
+        return failed;
+    }
+
+    /**
+     * @brief Writes a number with a fixed number of decimal places, padded on the left up to the specified width.
+     * @param number the number
+     * @param precision the number of decimal places
+     * @param width the minimum width
+     */
+    static void writeFixed(double number, int precision, int width) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), number, std::chars_format::fixed, precision);
+
+        std::string_view number_(digits, result.ptr - digits);
+        IO::err << std::string((size_t) std::max(0, width - (int) number_.size()), ' ') << number_;
+    }
+
+    /**
+     * @brief Writes a column of a table, padded up to the specified width.
+     * @param text the contents of the column
+     * @param width the minimum width
+     * @param left boolean indicating if the text is aligned to the left
+     */
+    static void writeColumn(std::string_view text, int width, bool left) {
+        std::string padding((size_t) std::max(0, width - (int) text.size()), ' ');
+        if (left) IO::err << text << padding;
+        else IO::err << padding << text;
+    }
+
+    /**
+     * @brief Prints a summary of the execution of the script to the standard error, so it does not mix with the
+     * output of the commands.
+     */
+    void ScriptReport::print() const {
+        double seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+
+        IO::err << "Executed " << executed << " commands (" << failed << " invalid) in ";
+        writeFixed(seconds * 1e3, 3, 0);
+        IO::err << " ms";
+
+        if (seconds > 0) {
+            IO::err << " (";
+            writeFixed((double) executed / seconds, 0, 0);
+            IO::err << " commands/s)";
+        }
+
+        IO::err << '\n';
+        if (!timings) return;
+
+        // execution time of each command
+        IO::err << '\n';
+        writeColumn("Command", 32, true);
+        writeColumn("Count", 12, false);
+        writeColumn("Total (ms)", 16, false);
+        writeColumn("Mean (us)", 16, false);
+        IO::err << '\n';
+
+        for (size_t i = 0; i < counts.size(); ++i) {
+            if (!counts[i]) continue;
+
+            writeColumn(names[i], 32, true);
+            writeColumn(std::to_string(counts[i]), 12, false);
+            writeFixed((double) nanoseconds[i] / 1e6, 3, 16);
+            writeFixed((double) nanoseconds[i] / 1e3 / (double) counts[i], 3, 16);
+            IO::err << '\n';
+        }
+    }
+}
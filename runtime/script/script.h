@@ -0,0 +1,91 @@
+#ifndef HELPY_RUNTIME_SCRIPT_H
+#define HELPY_RUNTIME_SCRIPT_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace HelpyRuntime {
+    /**
+     * @brief A script, i.e. a file containing one command per line, which is executed without any user interaction.
+     *
+     * Regular files are mapped into memory, whereas other sources (e.g. pipes) are read in large blocks, so that
+     * reading a line rarely requires a system call. The lines are returned as views of the underlying buffer.
+     */
+    class Script {
+        int fd;
+        bool mapped, eof;
+
+        const char *data;
+        size_t begin, end;
+        std::vector<char> buffer;
+
+    /* CONSTRUCTOR */
+    public:
+        explicit Script(const char *path);
+        Script(const Script &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~Script();
+
+    /* METHODS */
+    private:
+        bool fill();
+
+    public:
+        [[nodiscard]] bool isOpen() const;
+        bool nextLine(std::string_view &line);
+
+        static size_t split(std::string_view line, std::string_view *words, size_t maxWords);
+    };
+
+    /**
+     * @brief Collects the results of the execution of a script, namely the invalid lines and, optionally, the
+     * execution time of each command.
+     */
+    class ScriptReport {
+        using Clock = std::chrono::steady_clock;
+
+        const std::string_view *names;
+        bool timings;
+
+        uint64_t executed, failed;
+        std::vector<uint64_t> counts, nanoseconds;
+        Clock::time_point startTime, commandStartTime;
+
+    /* CONSTRUCTOR */
+    public:
+        ScriptReport(const std::string_view *names, size_t numCommands, bool timings);
+
+    /* METHODS */
+    public:
+        /**
+         * @brief Marks the start of the execution of a command.
+         */
+        void start() {
+            if (timings) commandStartTime = Clock::now();
+        }
+
+        /**
+         * @brief Marks the end of the execution of a command.
+         * @param command the index of the command that was executed
+         */
+        void finish(size_t command) {
+            ++executed;
+            if (!timings) return;
+
+            ++counts[command];
+            nanoseconds[command] += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - commandStartTime).count();
+        }
+
+        void fail(size_t lineNumber, std::string_view line, std::string_view suggestion = "");
+        [[nodiscard]] uint64_t failures() const;
+        void print() const;
+    };
+}
+
+#endif //HELPY_RUNTIME_SCRIPT_H
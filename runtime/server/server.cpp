@@ -0,0 +1,442 @@
+#include "server.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../io/io.h"
+#include "../trace/trace.h"
+
+// the maximum number of events handled per iteration of the event loop
+#define MAX_EVENTS 64
+
+namespace HelpyRuntime {
+    /**
+     * @brief Creates the pool and starts its workers.
+     * @param numWorkers the number of workers, or 0 to start one per hardware thread
+     */
+    WorkerPool::WorkerPool(unsigned numWorkers) : stopping(false) {
+        if (!numWorkers) numWorkers = std::max(1u, std::thread::hardware_concurrency());
+
+        for (unsigned i = 0; i < numWorkers; ++i)
+            workers.emplace_back(&WorkerPool::work, this);
+    }
+
+    /**
+     * @brief Executes the remaining tasks and stops the workers.
+     */
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        available.notify_all();
+
+        for (std::thread &worker : workers)
+            worker.join();
+    }
+
+    /**
+     * @brief Executes tasks until the pool is destroyed.
+     */
+    void WorkerPool::work() {
+        for (;;) {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                available.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+                if (tasks.empty()) return;
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    /**
+     * @brief Submits a task, which is executed as soon as a worker is available.
+     * @param task the task
+     */
+    void WorkerPool::submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+
+        available.notify_one();
+    }
+
+    /**
+     * @brief Returns the number of workers.
+     * @return the number of workers
+     */
+    size_t WorkerPool::size() const {
+        return workers.size();
+    }
+
+    /**
+     * @brief A connection to a client. The event loop reads the lines the client sends, whereas the worker that
+     * executes its commands consumes them and sends the replies.
+     */
+    struct Server::Session {
+        int fd;
+        std::string received; // the last line received, while it is incomplete (only used by the event loop)
+
+        std::mutex mutex;
+        std::condition_variable input;
+        std::deque<std::string> lines; // the lines that were received but not consumed
+        bool busy;
+        bool eof; // whether the client will send no more lines
+        bool closed; // whether the connection can no longer be used
+
+        explicit Session(int fd) : fd(fd), busy(false), eof(false), closed(false) {}
+
+        ~Session() {
+            ::close(fd);
+        }
+    };
+
+    // the eventfd that wakes the event loop up when the server is interrupted
+    static int interruptFd = -1;
+
+    static void interrupt(int) {
+        uint64_t one = 1;
+        if (write(interruptFd, &one, sizeof(one)) < 0) {}
+    }
+
+    /**
+     * @brief Creates the server, which only starts listening when it is run.
+     * @param path the path to the socket
+     * @param numWorkers the number of workers that execute the commands, or 0 to use one per hardware thread
+     * @param handler the function that executes the lines the clients send
+     */
+    Server::Server(std::string path, unsigned numWorkers, Handler handler)
+        : path(std::move(path)), handler(std::move(handler)), workers(numWorkers), listener(-1), epoll(-1),
+          wakeup(-1) {}
+
+    /**
+     * @brief Disconnects the clients and removes the socket.
+     */
+    Server::~Server() {
+        while (!sessions.empty())
+            close(sessions.begin()->first, true);
+
+        if (listener >= 0) {
+            ::close(listener);
+            unlink(path.c_str());
+        }
+
+        if (epoll >= 0) ::close(epoll);
+        if (wakeup >= 0) ::close(wakeup);
+    }
+
+    /**
+     * @brief Adds a file descriptor to the event loop.
+     * @param fd the file descriptor
+     * @param events the events the file descriptor is watched for
+     * @return 'true' if the file descriptor is watched, 'false' otherwise
+     */
+    bool Server::watch(int fd, unsigned events) const {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+
+        return !epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    /**
+     * @brief Accepts the pending connections.
+     */
+    void Server::accept() {
+        for (;;) {
+            int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                return;
+            }
+
+            auto session = std::make_shared<Session>(fd);
+            if (watch(fd, EPOLLIN | EPOLLRDHUP)) sessions[fd] = std::move(session);
+        }
+    }
+
+    /**
+     * @brief Reads what a client sent. If it completes a line and no command of the client is running, the line is
+     * executed; otherwise, it is kept until the command that is running reads it or finishes.
+     * @param session the session of the client
+     */
+    void Server::receive(const std::shared_ptr<Session> &session) {
+        char buffer[HELPY_IO_BUFFER_SIZE];
+        bool eof = false, error = false;
+        std::vector<std::string> lines;
+
+        for (;;) {
+            ssize_t size = read(session->fd, buffer, sizeof(buffer));
+
+            if (size < 0) {
+                if (errno == EINTR) continue;
+
+                error = errno != EAGAIN && errno != EWOULDBLOCK;
+                break;
+            }
+
+            if (!size) {
+                eof = true;
+                break;
+            }
+
+            for (std::string_view data(buffer, size); !data.empty(); ) {
+                size_t newline = data.find('\n');
+                session->received += data.substr(0, newline);
+
+                if (newline == std::string_view::npos) break;
+                data.remove_prefix(newline + 1);
+
+                if (!session->received.empty() && session->received.back() == '\r') session->received.pop_back();
+                lines.push_back(std::move(session->received));
+                session->received.clear();
+            }
+        }
+
+        // the last line may not end with a newline
+        if (eof && !session->received.empty())
+            lines.push_back(std::move(session->received));
+
+        if (!lines.empty()) {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            std::move(lines.begin(), lines.end(), std::back_inserter(session->lines));
+
+            if (!session->busy) {
+                session->busy = true;
+                workers.submit([this, session] { serve(session); });
+            }
+            else session->input.notify_one();
+        }
+
+        if (eof || error) close(session->fd, error);
+    }
+
+    /**
+     * @brief Stops reading from a client. Unless the connection failed, the commands it already sent are still
+     * executed; otherwise, the command it is running, if any, fails as soon as it reads input.
+     * @param fd the socket of the client
+     * @param error boolean indicating if the connection failed
+     */
+    void Server::close(int fd, bool error) {
+        auto it = sessions.find(fd);
+        if (it == sessions.end()) return;
+
+        epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+
+        {
+            std::lock_guard<std::mutex> lock(it->second->mutex);
+
+            it->second->eof = true;
+            it->second->closed |= error;
+        }
+
+        it->second->input.notify_all();
+
+        // the socket is closed once the worker that executes the commands of the client releases the session
+        sessions.erase(it);
+    }
+
+    /**
+     * @brief Executes the commands of a client, one at a time, until it sent no more lines.
+     * @param session the session of the client
+     */
+    void Server::serve(const std::shared_ptr<Session> &session) {
+        for (;;) {
+            std::string line;
+
+            {
+                std::lock_guard<std::mutex> lock(session->mutex);
+
+                if (session->closed || session->lines.empty()) {
+                    session->busy = false;
+                    return;
+                }
+
+                line = std::move(session->lines.front());
+                session->lines.pop_front();
+            }
+
+            std::string output;
+            int status = 0;
+
+            try {
+                TraceScope trace("request");
+                IO::Capture capture(output);
+
+                // the following lines are the input of the command, which the client sends after seeing the prompt
+                IO::Feed feed([&session, &output](std::string &line_) {
+                    sendOutput(*session, output);
+
+                    std::unique_lock<std::mutex> lock(session->mutex);
+                    session->input.wait(lock, [&session] { return session->eof || !session->lines.empty(); });
+
+                    if (session->closed || session->lines.empty()) return false;
+
+                    line_ = std::move(session->lines.front());
+                    session->lines.pop_front();
+
+                    return true;
+                });
+
+                if (!handler(line)) {
+                    output += "Invalid command!\n";
+                    status = 1;
+                }
+            }
+            catch (const std::exception &e) {
+                ((output += "Error: ") += e.what()) += '\n';
+                status = 2;
+            }
+            catch (...) {
+                output += "Error: unknown error\n";
+                status = 2;
+            }
+
+            sendOutput(*session, output);
+            send(*session, "E " + std::to_string(status) + '\n');
+        }
+    }
+
+    /**
+     * @brief Sends data to a client. Only the worker that executes the commands of the client writes to its socket,
+     * so it waits for the client whenever the socket is full.
+     * @param session the session of the client
+     * @param data the data
+     */
+    void Server::send(Session &session, std::string_view data) {
+        while (!data.empty()) {
+            ssize_t sent = ::send(session.fd, data.data(), data.size(), MSG_NOSIGNAL);
+
+            if (sent >= 0) {
+                data.remove_prefix(sent);
+                continue;
+            }
+
+            if (errno == EINTR) continue;
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                pollfd pfd = {session.fd, POLLOUT, 0};
+                if (poll(&pfd, 1, -1) >= 0) continue;
+            }
+
+            // the client is gone, so its remaining commands are not executed
+            std::lock_guard<std::mutex> lock(session.mutex);
+            session.closed = true;
+
+            return;
+        }
+    }
+
+    /**
+     * @brief Sends the output a command produced so far to its client, without ANSI escape sequences, and empties it.
+     * @param session the session of the client
+     * @param output the output
+     */
+    void Server::sendOutput(Session &session, std::string &output) {
+        int state = 0;
+        output.resize(IO::stripEscapes(output.data(), output.size(), state));
+
+        if (output.empty()) return;
+
+        send(session, "O " + std::to_string(output.size()) + '\n' + output);
+        output.clear();
+    }
+
+    /**
+     * @brief Listens on the socket and serves the clients until the program is interrupted (Ctrl-C or SIGTERM).
+     * @return the exit status of the program
+     */
+    int Server::run() {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+
+        if (path.size() >= sizeof(address.sun_path)) {
+            IO::err << "The path to the socket '" << path << "' is too long!\n";
+            return EXIT_FAILURE;
+        }
+
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        // a socket left behind by a server that did not exit cleanly would prevent binding
+        unlink(path.c_str());
+
+        listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        epoll = epoll_create1(EPOLL_CLOEXEC);
+        wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (listener < 0 || epoll < 0 || wakeup < 0 || bind(listener, (sockaddr *) &address, sizeof(address))
+            || listen(listener, SOMAXCONN) || !watch(listener, EPOLLIN) || !watch(wakeup, EPOLLIN)) {
+            IO::err << "Could not listen on '" << path << "': " << strerror(errno) << '\n';
+            return EXIT_FAILURE;
+        }
+
+        // stop serving when the program is interrupted
+        struct sigaction action = {}, previousInt = {}, previousTerm = {};
+        action.sa_handler = interrupt;
+        sigemptyset(&action.sa_mask);
+
+        interruptFd = wakeup;
+        sigaction(SIGINT, &action, &previousInt);
+        sigaction(SIGTERM, &action, &previousTerm);
+
+        IO::err << "Listening on '" << path << "' with " << workers.size() << " workers.\n";
+
+        epoll_event events[MAX_EVENTS];
+
+        for (bool running = true; running; ) {
+            int numEvents = epoll_wait(epoll, events, MAX_EVENTS, -1);
+
+            if (numEvents < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+
+            for (int i = 0; i < numEvents; ++i) {
+                int fd = events[i].data.fd;
+
+                if (fd == wakeup) {
+                    running = false;
+                    continue;
+                }
+
+                if (fd == listener) {
+                    accept();
+                    continue;
+                }
+
+                auto it = sessions.find(fd);
+                if (it == sessions.end()) continue;
+
+                std::shared_ptr<Session> session = it->second;
+                receive(session);
+            }
+        }
+
+        sigaction(SIGINT, &previousInt, nullptr);
+        sigaction(SIGTERM, &previousTerm, nullptr);
+        interruptFd = -1;
+
+        IO::err << "The server was stopped.\n";
+        return EXIT_SUCCESS;
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef HELPY_RUNTIME_SERVER_H
+#define HELPY_RUNTIME_SERVER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace HelpyRuntime {
+    /**
+     * @brief A fixed number of threads that execute tasks in the order they are submitted.
+     */
+    class WorkerPool {
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        bool stopping;
+
+        std::mutex mutex;
+        std::condition_variable available;
+
+    /* CONSTRUCTOR */
+    public:
+        explicit WorkerPool(unsigned numWorkers = 0);
+        WorkerPool(const WorkerPool &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~WorkerPool();
+
+    /* METHODS */
+    private:
+        void work();
+
+    public:
+        void submit(std::function<void()> task);
+        [[nodiscard]] size_t size() const;
+    };
+
+    /**
+     * @brief Serves clients over a Unix domain socket, so many clients (e.g. automation scripts) can drive the same
+     * long-lived process.
+     *
+     * The connections are multiplexed by a single thread with epoll, and the commands are executed by a pool of
+     * workers. Each client sends one command per line, and the lines that follow a command are its input, if it
+     * reads any. The commands of a client are executed one at a time, in order, whereas the commands of different
+     * clients are executed concurrently. The input and output of the commands are isolated per client (see
+     * IO::Feed and IO::Capture), and the server replies to each command with:
+     * - any number of output frames, "O <length>\n" followed by that many bytes, which are sent when the command
+     * finishes or asks for input;
+     * - an end frame, "E <status>\n", where the status is 0 if the command was executed, 1 if it is invalid and 2
+     * if it failed (e.g. it threw an exception).
+     */
+    class Server {
+    public:
+        // executes a line sent by a client, returning 'false' if it is not a command
+        using Handler = std::function<bool(std::string_view line)>;
+
+    private:
+        struct Session;
+
+        std::string path;
+        Handler handler;
+        WorkerPool workers;
+
+        int listener, epoll, wakeup;
+        std::unordered_map<int, std::shared_ptr<Session>> sessions;
+
+    /* CONSTRUCTOR */
+    public:
+        Server(std::string path, unsigned numWorkers, Handler handler);
+        Server(const Server &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~Server();
+
+    /* METHODS */
+    private:
+        bool watch(int fd, unsigned events) const;
+        void accept();
+        void receive(const std::shared_ptr<Session> &session);
+        void close(int fd, bool error);
+        void serve(const std::shared_ptr<Session> &session);
+        static void send(Session &session, std::string_view data);
+        static void sendOutput(Session &session, std::string &output);
+
+    public:
+        int run();
+    };
+}
+
+#endif //HELPY_RUNTIME_SERVER_H
@@ -0,0 +1,296 @@
+#include "stats.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+
+namespace HelpyRuntime {
+    /**
+     * @brief Creates an empty histogram.
+     */
+    LatencyHistogram::LatencyHistogram()
+        : counts(), count_(0), sum(0), min_(std::numeric_limits<uint64_t>::max()), max_(0) {}
+
+    /**
+     * @brief Computes the highest value that is recorded in a bucket.
+     * @param bucket the index of the bucket
+     * @return the highest value of the bucket
+     */
+    uint64_t LatencyHistogram::highestEquivalent(size_t bucket) {
+        if (bucket < 2 * SUB_BUCKETS) return bucket;
+
+        int shift = (int) (bucket / SUB_BUCKETS) - 1;
+        uint64_t mantissa = bucket % SUB_BUCKETS + SUB_BUCKETS;
+
+        // the last bucket ends at the highest 64-bit value, which the shift wraps around to
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    /**
+     * @brief Adds the values recorded by another histogram to this one (e.g. to combine the histograms of several
+     * threads).
+     * @param other the other histogram
+     */
+    void LatencyHistogram::add(const LatencyHistogram &other) {
+        for (size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket)
+            counts[bucket] += other.counts[bucket];
+
+        count_ += other.count_;
+        sum += other.sum;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    /**
+     * @brief Returns the number of values that were recorded.
+     * @return the number of values
+     */
+    uint64_t LatencyHistogram::count() const {
+        return count_;
+    }
+
+    /**
+     * @brief Returns the lowest value that was recorded, which is exact.
+     * @return the lowest value, or 0 if the histogram is empty
+     */
+    uint64_t LatencyHistogram::min() const {
+        return count_ ? min_ : 0;
+    }
+
+    /**
+     * @brief Returns the highest value that was recorded, which is exact.
+     * @return the highest value
+     */
+    uint64_t LatencyHistogram::max() const {
+        return max_;
+    }
+
+    /**
+     * @brief Returns the mean of the values that were recorded, which is exact.
+     * @return the mean, or 0 if the histogram is empty
+     */
+    double LatencyHistogram::mean() const {
+        return count_ ? (double) sum / (double) count_ : 0;
+    }
+
+    /**
+     * @brief Computes a percentile of the values that were recorded.
+     * @param percentile the percentile, between 0 and 100
+     * @return the highest value of the bucket the percentile falls in, limited to the range of the values recorded
+     */
+    uint64_t LatencyHistogram::percentile(double percentile) const {
+        if (!count_) return 0;
+
+        auto target = (uint64_t) std::ceil(percentile / 100 * (double) count_);
+        target = std::clamp<uint64_t>(target, 1, count_);
+
+        uint64_t accumulated = 0;
+
+        for (size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+            if ((accumulated += counts[bucket]) >= target)
+                return std::clamp(highestEquivalent(bucket), min_, max_);
+        }
+
+        return max_;
+    }
+
+    /**
+     * @brief Returns the number of values recorded in a bucket.
+     * @param bucket the index of the bucket
+     * @return the number of values
+     */
+    uint64_t LatencyHistogram::bucketCount(size_t bucket) const {
+        return counts[bucket];
+    }
+
+    /**
+     * @brief Creates the latency statistics.
+     * @param names the names of the commands, indexed by command
+     * @param numCommands the number of commands
+     */
+    LatencyStats::LatencyStats(const std::string_view *names, size_t numCommands)
+        : names(names), histograms(numCommands), shared(false) {
+        if (const char *path_ = getenv("HELPY_STATS"); path_ && *path_)
+            path = path_;
+    }
+
+    /**
+     * @brief Saves the histograms, if the HELPY_STATS environment variable is set.
+     */
+    LatencyStats::~LatencyStats() {
+        save();
+    }
+
+    /**
+     * @brief Allocates the histogram of a command, which is only done the first time it is executed so that unused
+     * commands cost no memory.
+     * @param command the index of the command
+     * @return the histogram
+     */
+    LatencyHistogram &LatencyStats::create(size_t command) {
+        histograms[command] = std::make_unique<LatencyHistogram>();
+        return *histograms[command];
+    }
+
+    /**
+     * @brief Records the latency of an execution of a command while commands may be executed concurrently.
+     * @param command the index of the command
+     * @param ticks the latency, in ticks
+     */
+    void LatencyStats::recordShared(size_t command, uint64_t ticks) {
+        std::lock_guard<std::mutex> lock(mutex);
+        LatencyHistogram *histogram = histograms[command].get();
+
+        (histogram ? *histogram : create(command)).record(ticks);
+    }
+
+    /**
+     * @brief Sets whether commands may be executed concurrently, in which case the histograms are locked while they
+     * are updated. It must be set before the concurrent executions start.
+     * @param shared boolean indicating if commands may be executed concurrently
+     */
+    void LatencyStats::share(bool shared) {
+        this->shared = shared;
+    }
+
+    /**
+     * @brief Appends a number with a fixed number of decimal places to a string, padded on the left up to the
+     * specified width.
+     * @param out the string
+     * @param number the number
+     * @param precision the number of decimal places
+     * @param width the minimum width
+     */
+    static void appendFixed(std::string &out, double number, int precision, int width = 0) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), number, std::chars_format::fixed, precision);
+
+        size_t length = result.ptr - digits;
+        if ((int) length < width) out.append(width - length, ' ');
+
+        out.append(digits, length);
+    }
+
+    /**
+     * @brief Appends a column of a table to a string, padded up to the specified width.
+     * @param out the string
+     * @param text the contents of the column
+     * @param width the minimum width
+     * @param left boolean indicating if the text is aligned to the left
+     */
+    static void appendColumn(std::string &out, std::string_view text, int width, bool left) {
+        size_t padding = (size_t) std::max(0, width - (int) text.size());
+
+        if (!left) out.append(padding, ' ');
+        out += text;
+        if (left) out.append(padding, ' ');
+    }
+
+    /**
+     * @brief Renders the latency of the commands that were executed as a table, in microseconds.
+     * @return the table, which does not end with a newline
+     */
+    std::string LatencyStats::table() {
+        double scale = converter.nanosecondsPerTick() / 1e3;
+        std::string out;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        appendColumn(out, "Command", 32, true);
+        appendColumn(out, "Count", 10, false);
+
+        for (const char *column : {"Min (us)", "Mean (us)", "p50 (us)", "p90 (us)", "p99 (us)", "Max (us)"})
+            appendColumn(out, column, 12, false);
+
+        bool empty = true;
+
+        for (size_t i = 0; i < histograms.size(); ++i) {
+            const LatencyHistogram *histogram = histograms[i].get();
+            if (!histogram) continue;
+
+            out += '\n';
+            appendColumn(out, names[i], 32, true);
+            appendColumn(out, std::to_string(histogram->count()), 10, false);
+
+            for (double ticks : {(double) histogram->min(), histogram->mean(), (double) histogram->percentile(50),
+                                 (double) histogram->percentile(90), (double) histogram->percentile(99),
+                                 (double) histogram->max()})
+                appendFixed(out, ticks * scale, 3, 12);
+
+            empty = false;
+        }
+
+        if (empty) out += "\nNo command was executed yet.";
+        return out;
+    }
+
+    /**
+     * @brief Renders the histograms of the commands that were executed as JSON, in nanoseconds. Each bucket that is
+     * not empty is listed as a pair of its highest value and its count.
+     * @return the JSON document
+     */
+    std::string LatencyStats::json() {
+        double scale = converter.nanosecondsPerTick();
+        std::string out = "{\n  \"unit\": \"ns\",\n  \"commands\": [";
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        bool first = true;
+
+        for (size_t i = 0; i < histograms.size(); ++i) {
+            const LatencyHistogram *histogram = histograms[i].get();
+            if (!histogram) continue;
+
+            // the names of the commands are keywords, which never need to be escaped
+            out += first ? "\n" : ",\n";
+            out += "    {\"name\": \"";
+            out += names[i];
+            out += "\", \"count\": " + std::to_string(histogram->count());
+
+            std::pair<const char *, double> fields[] = {
+                {"min", (double) histogram->min()}, {"mean", histogram->mean()},
+                {"p50", (double) histogram->percentile(50)}, {"p90", (double) histogram->percentile(90)},
+                {"p99", (double) histogram->percentile(99)}, {"p999", (double) histogram->percentile(99.9)},
+                {"max", (double) histogram->max()}
+            };
+
+            for (const auto &[key, ticks] : fields) {
+                ((out += ", \"") += key) += "\": ";
+                appendFixed(out, ticks * scale, 1);
+            }
+
+            out += ", \"buckets\": [";
+            bool firstBucket = true;
+
+            for (size_t bucket = 0; bucket < LatencyHistogram::NUM_BUCKETS; ++bucket) {
+                uint64_t count = histogram->bucketCount(bucket);
+                if (!count) continue;
+
+                out += firstBucket ? "[" : ", [";
+                appendFixed(out, (double) LatencyHistogram::highestEquivalent(bucket) * scale, 1);
+                out += ", " + std::to_string(count) + ']';
+
+                firstBucket = false;
+            }
+
+            out += "]}";
+            first = false;
+        }
+
+        out += first ? "]\n}\n" : "\n  ]\n}\n";
+        return out;
+    }
+
+    /**
+     * @brief Writes the histograms to the file the HELPY_STATS environment variable points to, if it is set.
+     */
+    void LatencyStats::save() {
+        if (path.empty()) return;
+
+        std::ofstream out(path);
+        out << json();
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef HELPY_RUNTIME_STATS_H
+#define HELPY_RUNTIME_STATS_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../utils/ticks.h"
+
+namespace HelpyRuntime {
+    /**
+     * @brief A histogram of latencies whose buckets grow exponentially, like HdrHistogram. Each power of two is split
+     * into 16 buckets, so any value is recorded in constant time and memory with a relative error below 6.25%.
+     */
+    class LatencyHistogram {
+    public:
+        static constexpr int SUB_BUCKET_BITS = 4;
+        static constexpr size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static constexpr size_t NUM_BUCKETS = (65 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    private:
+        uint64_t counts[NUM_BUCKETS];
+        uint64_t count_, sum, min_, max_;
+
+    /* CONSTRUCTOR */
+    public:
+        LatencyHistogram();
+
+    /* METHODS */
+    public:
+        /**
+         * @brief Computes the bucket of a value. The values below 32 have a bucket each, whereas the others are
+         * grouped by their 5 most significant bits.
+         * @param value the value
+         * @return the index of the bucket
+         */
+        static size_t bucket(uint64_t value) {
+            if (value < 2 * SUB_BUCKETS) return value;
+
+            int shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+            return shift * SUB_BUCKETS + (value >> shift);
+        }
+
+        static uint64_t highestEquivalent(size_t bucket);
+
+        /**
+         * @brief Records a value.
+         * @param value the value
+         */
+        void record(uint64_t value) {
+            ++counts[bucket(value)];
+            ++count_;
+            sum += value;
+
+            if (value < min_) min_ = value;
+            if (value > max_) max_ = value;
+        }
+
+        void add(const LatencyHistogram &other);
+
+        [[nodiscard]] uint64_t count() const;
+        [[nodiscard]] uint64_t min() const;
+        [[nodiscard]] uint64_t max() const;
+        [[nodiscard]] double mean() const;
+        [[nodiscard]] uint64_t percentile(double percentile) const;
+        [[nodiscard]] uint64_t bucketCount(size_t bucket) const;
+    };
+
+    /**
+     * @brief Records the latency of each command in a histogram, which is displayed by the built-in command 'stats'
+     * of the advanced mode (see table()).
+     *
+     * The latencies are measured with the time-stamp counter of the processor, when there is one, as reading it is
+     * much cheaper than reading the clock, and are only converted to nanoseconds when displayed. The histogram of a
+     * command is allocated the first time it is executed. If the HELPY_STATS environment variable is set, the
+     * histograms are written to the file it points to, as JSON, when the object is destroyed.
+     */
+    class LatencyStats {
+        std::string path;
+        const std::string_view *names;
+        std::vector<std::unique_ptr<LatencyHistogram>> histograms;
+        Utils::TickConverter converter;
+
+        bool shared; // whether the commands are executed concurrently (e.g. by the server)
+        std::mutex mutex;
+
+    /* CONSTRUCTOR */
+    public:
+        LatencyStats(const std::string_view *names, size_t numCommands);
+        LatencyStats(const LatencyStats &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~LatencyStats();
+
+    /* METHODS */
+    private:
+        LatencyHistogram &create(size_t command);
+        void recordShared(size_t command, uint64_t ticks);
+        void save();
+
+    public:
+        /**
+         * @brief Reads the time-stamp counter or, if the processor has none, the clock.
+         * @return the current time, in ticks
+         */
+        static uint64_t now() {
+            return Utils::readTicks();
+        }
+
+        /**
+         * @brief Records the latency of an execution of a command.
+         * @param command the index of the command
+         * @param start the time the command started, in ticks (see now())
+         */
+        void record(size_t command, uint64_t start) {
+            uint64_t ticks = now() - start;
+
+            if (shared) {
+                recordShared(command, ticks);
+                return;
+            }
+
+            LatencyHistogram *histogram = histograms[command].get();
+
+            (histogram ? *histogram : create(command)).record(ticks);
+        }
+
+        void share(bool shared);
+        [[nodiscard]] std::string table();
+        [[nodiscard]] std::string json();
+    };
+}
+
+#endif //HELPY_RUNTIME_STATS_H
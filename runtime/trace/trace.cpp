@@ -0,0 +1,173 @@
+#include "trace.h"
+
+#include <charconv>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../io/io.h"
+
+namespace HelpyRuntime {
+    /**
+     * @brief The spans of a thread. Only the thread writes to its buffer, so the number of spans is the only field
+     * that must be synchronized with the readers.
+     */
+    struct TraceBuffer {
+        Trace::Span spans[Trace::CAPACITY];
+        std::atomic<uint64_t> size = 0; // the number of spans ever recorded
+        size_t thread;
+    };
+
+    // the buffers of the threads that recorded spans, which are kept until the program ends, as are the threads' ids
+    static std::mutex mutex;
+    static std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    static thread_local TraceBuffer *buffer = nullptr;
+
+    static Utils::TickConverter converter;
+
+    /**
+     * @brief Allocates the buffer of the current thread.
+     * @return the buffer
+     */
+    static TraceBuffer *createBuffer() {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        buffers.push_back(std::make_unique<TraceBuffer>());
+        buffers.back()->thread = buffers.size();
+
+        return buffer = buffers.back().get();
+    }
+
+    /**
+     * @brief Starts tracing. The spans previously recorded are discarded.
+     */
+    void Trace::start() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            for (const auto &buffer_ : buffers)
+                buffer_->size = 0;
+        }
+
+        // the buffer of the thread that starts tracing is allocated beforehand
+        if (!buffer) createBuffer();
+
+        converter = Utils::TickConverter();
+        enabled_ = true;
+    }
+
+    /**
+     * @brief Stops tracing.
+     */
+    void Trace::stop() {
+        enabled_ = false;
+    }
+
+    /**
+     * @brief Records a span in the buffer of the current thread.
+     * @param name the name of the span, which must outlive the trace
+     * @param begin the time the span began, in ticks
+     * @param end the time the span ended, in ticks
+     */
+    void Trace::record(std::string_view name, uint64_t begin, uint64_t end) {
+        TraceBuffer *buffer_ = buffer ? buffer : createBuffer();
+        uint64_t size = buffer_->size.load(std::memory_order_relaxed);
+
+        buffer_->spans[size % CAPACITY] = {name, begin, end};
+        buffer_->size.store(size + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Appends a string to a JSON document, escaping the characters that cannot appear in a JSON string.
+     * @param out the JSON document
+     * @param text the string
+     */
+    static void appendEscaped(std::string &out, std::string_view text) {
+        for (char c : text) {
+            if (c == '"' || c == '\\') (out += '\\') += c;
+            else if ((unsigned char) c < 0x20) out += ' ';
+            else out += c;
+        }
+    }
+
+    /**
+     * @brief Appends a duration to a JSON document, in microseconds.
+     * @param out the JSON document
+     * @param nanoseconds the duration, in nanoseconds
+     */
+    static void appendMicroseconds(std::string &out, double nanoseconds) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), nanoseconds / 1e3, std::chars_format::fixed, 3);
+
+        out.append(digits, result.ptr - digits);
+    }
+
+    /**
+     * @brief Saves the spans recorded since tracing started in the Chrome trace-event format. It should be called
+     * once the threads stop recording spans, as the spans that are overwritten meanwhile may be saved incompletely.
+     * @param path the path to the file
+     * @return 'true' if the file was written, 'false' otherwise
+     */
+    bool Trace::save(const char *path) {
+        double scale = converter.nanosecondsPerTick();
+        uint64_t origin = converter.origin();
+
+        std::string out = "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+        bool first = true;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (const auto &buffer_ : buffers) {
+            std::string tid = std::to_string(buffer_->thread);
+
+            // name the threads, the first of which started tracing
+            out += first ? "\n" : ",\n";
+            out += "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " + tid + ", \"args\": {\"name\": \""
+                + (buffer_->thread == 1 ? std::string("main") : "thread " + tid) + "\"}}";
+
+            first = false;
+
+            uint64_t size = buffer_->size.load(std::memory_order_acquire);
+
+            for (uint64_t i = (size > CAPACITY) ? size - CAPACITY : 0; i < size; ++i) {
+                const Span &span = buffer_->spans[i % CAPACITY];
+                if (span.begin < origin) continue;
+
+                out += ",\n{\"name\": \"";
+                appendEscaped(out, span.name);
+                out += "\", \"cat\": \"helpy\", \"ph\": \"X\", \"ts\": ";
+                appendMicroseconds(out, (double) (span.begin - origin) * scale);
+                out += ", \"dur\": ";
+                appendMicroseconds(out, (double) (span.end - span.begin) * scale);
+                out += ", \"pid\": 1, \"tid\": " + tid + '}';
+            }
+        }
+
+        out += "\n]}\n";
+
+        std::ofstream file(path);
+        return (file << out) && file.flush();
+    }
+
+    /**
+     * @brief Starts tracing, unless no path is given.
+     * @param path the path to the file where the trace will be saved, or nullptr not to trace the program
+     */
+    TraceRecorder::TraceRecorder(const char *path) : path(path) {
+        if (path) Trace::start();
+    }
+
+    /**
+     * @brief Stops tracing and saves the trace.
+     */
+    TraceRecorder::~TraceRecorder() {
+        if (!path) return;
+
+        Trace::stop();
+
+        if (!Trace::save(path))
+            IO::err << "Could not write the trace to '" << path << "'!\n";
+    }
+}
@@ -0,0 +1,116 @@
+#ifndef HELPY_RUNTIME_TRACE_H
+#define HELPY_RUNTIME_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+#include "../utils/ticks.h"
+
+namespace HelpyRuntime {
+    /**
+     * @brief Records the spans of time a program spends on each activity (e.g. waiting for input, dispatching and
+     * running commands), so they can be visualized in a trace viewer such as chrome://tracing or Perfetto.
+     *
+     * Each thread records its spans in a ring buffer of its own, so recording requires neither locks nor memory
+     * allocations, except when a thread records its first span. Once the buffer of a thread is full, its oldest
+     * spans are overwritten. Tracing is disabled by default, in which case recording a span costs a single load.
+     */
+    class Trace {
+    public:
+        struct Span {
+            std::string_view name;
+            uint64_t begin, end; // in ticks (see Utils::readTicks())
+        };
+
+        static constexpr size_t CAPACITY = 1 << 14; // the number of spans each thread keeps
+
+    private:
+        static inline std::atomic<bool> enabled_ = false;
+
+    /* METHODS */
+    public:
+        /**
+         * @brief Verifies if tracing is enabled.
+         * @return 'true' if spans are being recorded, 'false' otherwise
+         */
+        static bool enabled() {
+            return enabled_.load(std::memory_order_relaxed);
+        }
+
+        static void start();
+        static void stop();
+        static void record(std::string_view name, uint64_t begin, uint64_t end);
+        static bool save(const char *path);
+    };
+
+    /**
+     * @brief Records a span that lasts from its creation until its destruction, if tracing is enabled.
+     */
+    class TraceScope {
+        std::string_view name;
+        uint64_t begin;
+
+    /* CONSTRUCTOR */
+    public:
+        /**
+         * @brief Starts a span.
+         * @param name the name of the span, which must outlive the trace (e.g. a string literal)
+         */
+        explicit TraceScope(std::string_view name)
+            : name(name), begin(Trace::enabled() ? Utils::readTicks() : 0) {}
+
+        TraceScope(const TraceScope &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~TraceScope() {
+            if (begin) Trace::record(name, begin, Utils::readTicks());
+        }
+
+    /* METHODS */
+    public:
+        /**
+         * @brief Ends the current span and starts another one, which lasts until the scope is destroyed.
+         * @param next the name of the next span, which must outlive the trace
+         */
+        void split(std::string_view next) {
+            if (!begin) return;
+
+            uint64_t now = Utils::readTicks();
+            Trace::record(name, begin, now);
+
+            name = next;
+            begin = now;
+        }
+    };
+
+    /**
+     * @brief Traces the program from its creation until its destruction, when the trace is saved to a file in the
+     * Chrome trace-event format.
+     */
+    class TraceRecorder {
+        const char *path;
+
+    /* CONSTRUCTOR */
+    public:
+        explicit TraceRecorder(const char *path);
+        TraceRecorder(const TraceRecorder &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~TraceRecorder();
+    };
+}
+
+#define HELPY_TRACE_CONCAT_(lhs, rhs) lhs##rhs
+#define HELPY_TRACE_CONCAT(lhs, rhs) HELPY_TRACE_CONCAT_(lhs, rhs)
+
+/*
+ * Records a span that lasts until the end of the enclosing scope, e.g. TRACE_SCOPE("sort the results").
+ */
+#ifndef TRACE_SCOPE
+#define TRACE_SCOPE(name) HelpyRuntime::TraceScope HELPY_TRACE_CONCAT(traceScope, __LINE__)(name)
+#endif
+
+#endif //HELPY_RUNTIME_TRACE_H
@@ -0,0 +1,78 @@
+#include "usage.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#define uMap std::unordered_map
+
+namespace HelpyRuntime {
+    /**
+     * @brief Creates the usage recorder.
+     * @param names the names of the commands, indexed by command
+     * @param numCommands the number of commands
+     */
+    UsageRecorder::UsageRecorder(const std::string_view *names, size_t numCommands)
+        : names(names), numCommands(numCommands) {
+        const char *path_ = getenv("HELPY_PROFILE");
+        if (!path_ || !*path_) return;
+
+        path = path_;
+        counts = std::make_unique<std::atomic<uint64_t>[]>(numCommands);
+    }
+
+    /**
+     * @brief Saves the recorded usage, if recording is enabled.
+     */
+    UsageRecorder::~UsageRecorder() {
+        save();
+    }
+
+    /**
+     * @brief Adds the recorded counts to the profile file.
+     *
+     * The profile contains one command per line, preceded by the number of times it was executed.
+     */
+    void UsageRecorder::save() const {
+        if (!counts) return;
+
+        // the recorders of the sessions that are replayed in parallel may save the same profile at once
+        static std::mutex mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // read the counts that were previously recorded
+        uMap<std::string, uint64_t> profile;
+        std::ifstream in(path);
+
+        for (std::string line; getline(in, line); ) {
+            if (line.empty() || line.front() == '#') continue;
+
+            size_t space = line.find(' ');
+            if (space == std::string::npos) continue;
+
+            profile[line.substr(space + 1)] += strtoull(line.c_str(), nullptr, 10);
+        }
+
+        in.close();
+
+        for (size_t i = 0; i < numCommands; ++i) {
+            if (uint64_t count = counts[i].load())
+                profile[std::string(names[i])] += count;
+        }
+
+        // write the most used commands first
+        std::vector<std::pair<std::string, uint64_t>> commands(profile.begin(), profile.end());
+        std::sort(commands.begin(), commands.end(), [](const auto &lhs, const auto &rhs) {
+            return (lhs.second != rhs.second) ? lhs.second > rhs.second : lhs.first < rhs.first;
+        });
+
+        std::ofstream out(path);
+        out << "# Helpy usage profile\n";
+
+        for (const auto &[name, count] : commands)
+            out << count << ' ' << name << '\n';
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef HELPY_RUNTIME_USAGE_H
+#define HELPY_RUNTIME_USAGE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace HelpyRuntime {
+    /**
+     * @brief Records how many times each command is executed.
+     *
+     * Recording is opt-in: it only happens if the HELPY_PROFILE environment variable is set, in which case the
+     * counts are added to the profile file it points to when the recorder is destroyed. The profile can then be
+     * fed back to Helpy (helpy run --profile <file>) to optimize the generated code for the most used commands.
+     */
+    class UsageRecorder {
+        std::string path;
+        const std::string_view *names;
+        size_t numCommands;
+        std::unique_ptr<std::atomic<uint64_t>[]> counts; // atomic, as the server executes commands concurrently
+
+        // the last command executed by each thread
+        static inline thread_local size_t last_ = 0;
+
+    /* CONSTRUCTOR */
+    public:
+        UsageRecorder(const std::string_view *names, size_t numCommands);
+        UsageRecorder(const UsageRecorder &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~UsageRecorder();
+
+    /* METHODS */
+    private:
+        void save() const;
+
+    public:
+        /**
+         * @brief Records an execution of a command.
+         * @param command the index of the command
+         */
+        void record(size_t command) {
+            last_ = command;
+            if (counts) counts[command].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Removes executions of a command from the record, e.g. those of a benchmark, which are not usage.
+         * @param command the index of the command
+         * @param count the number of executions
+         */
+        void discard(size_t command, uint64_t count) {
+            if (counts) counts[command].fetch_sub(count, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Returns the last command that was executed by the calling thread.
+         * @return the index of the command
+         */
+        [[nodiscard]] size_t last() const {
+            return last_;
+        }
+    };
+}
+
+#endif //HELPY_RUNTIME_USAGE_H
@@ -0,0 +1,127 @@
+#ifndef HELPY_RUNTIME_NUMBERS_H
+#define HELPY_RUNTIME_NUMBERS_H
+
+#include <cctype>
+#include <charconv>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "../script/script.h"
+
+namespace HelpyRuntime::Utils {
+    /**
+     * @brief Extracts the next token of a text, i.e. the next sequence of characters delimited by whitespace.
+     * @param text the text
+     * @param pos the position where the search starts, which is updated to the position after the token
+     * @param token view which will store the token
+     * @return 'true' if a token was found, 'false' if the end of the text was reached
+     */
+    inline bool nextToken(std::string_view text, size_t &pos, std::string_view &token) {
+        while (pos < text.size() && isspace((unsigned char) text[pos])) ++pos;
+        if (pos == text.size()) return false;
+
+        size_t start = pos;
+        while (pos < text.size() && !isspace((unsigned char) text[pos])) ++pos;
+
+        token = text.substr(start, pos - start);
+        return true;
+    }
+
+    /**
+     * @brief Parses a number from a token, without allocating memory or throwing exceptions.
+     *
+     * Floating-point numbers only need to be at the start of the token (e.g. "12abc" is 12), like std::stod, whereas
+     * integers must span the whole token (e.g. "12.5" is not an integer). A leading '+' is accepted and, in base 16,
+     * so is the prefix "0x".
+     * @param token the token
+     * @param number variable which will store the number, which is left unchanged if the token is invalid
+     * @param base the base of integers
+     * @return 'true' if the token is a number within the range of the type, 'false' otherwise
+     */
+    template <typename T>
+    bool parseNumber(std::string_view token, T &number, int base = 10) {
+        if (!token.empty() && token.front() == '+' && (token.size() == 1 || token[1] != '-'))
+            token.remove_prefix(1);
+
+        if (base == 16 && token.size() > 2 && token[0] == '0' && (token[1] == 'x' || token[1] == 'X'))
+            token.remove_prefix(2);
+
+        const char *end = token.data() + token.size();
+        T number_;
+        std::from_chars_result result{};
+
+        if constexpr (std::is_floating_point_v<T>)
+            result = std::from_chars(token.data(), end, number_);
+        else
+            result = std::from_chars(token.data(), end, number_, base);
+
+        if (result.ec != std::errc() || (!std::is_floating_point_v<T> && result.ptr != end))
+            return false;
+
+        number = number_;
+        return true;
+    }
+
+    /**
+     * @brief Parses the first token of a text that is a number.
+     * @param text the text
+     * @param number variable which will store the number
+     * @param base the base of integers
+     * @return 'true' if the text contains a number, 'false' otherwise
+     */
+    template <typename T>
+    bool parseFirstNumber(std::string_view text, T &number, int base = 10) {
+        std::string_view token;
+
+        for (size_t pos = 0; nextToken(text, pos, token); ) {
+            if (parseNumber(token, number, base))
+                return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Parses every token of a text (e.g. a line or a whole file) that is a number, in a single pass.
+     * @param text the text
+     * @param numbers vector to which the numbers are appended
+     * @param base the base of integers
+     * @return the number of tokens that are not numbers
+     */
+    template <typename T>
+    size_t parseNumbers(std::string_view text, std::vector<T> &numbers, int base = 10) {
+        std::string_view token;
+        size_t invalid = 0;
+
+        for (size_t pos = 0; nextToken(text, pos, token); ) {
+            T number;
+
+            if (parseNumber(token, number, base)) numbers.push_back(number);
+            else ++invalid;
+        }
+
+        return invalid;
+    }
+
+    /**
+     * @brief Parses every token of a file that is a number, in a single pass over the (memory-mapped) file.
+     * @param path the path to the file
+     * @param numbers vector to which the numbers are appended
+     * @param base the base of integers
+     * @return 'true' if the file could be read, 'false' otherwise
+     */
+    template <typename T>
+    bool readNumbers(const char *path, std::vector<T> &numbers, int base = 10) {
+        Script file(path);
+        if (!file.isOpen()) return false;
+
+        for (std::string_view line; file.nextLine(line); )
+            parseNumbers(line, numbers, base);
+
+        return true;
+    }
+}
+
+#endif //HELPY_RUNTIME_NUMBERS_H
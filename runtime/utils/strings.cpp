@@ -0,0 +1,76 @@
+#include "strings.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace HelpyRuntime::Utils {
+    /**
+     * @brief Flips the case of the ASCII letters of a piece of text that are within a range (e.g. 'A' to 'Z'), 16
+     * characters at a time if SSE2 is available. Other characters, including those of UTF-8 sequences, are kept.
+     * @complexity O(n)
+     * @param data the start of the text
+     * @param size the size of the text
+     * @param first the first letter of the range
+     * @param last the last letter of the range
+     */
+    static void flipCase(char *data, size_t size, char first, char last) {
+        size_t i = 0;
+
+#if defined(__SSE2__)
+        // the comparisons are signed, so bytes above 127 (i.e. negative) are never in the range
+        const __m128i before = _mm_set1_epi8((char) (first - 1)), after = _mm_set1_epi8((char) (last + 1));
+        const __m128i flip = _mm_set1_epi8(0x20);
+
+        for (; i + 16 <= size; i += 16) {
+            __m128i block = _mm_loadu_si128((const __m128i *) (data + i));
+            __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(block, before), _mm_cmplt_epi8(block, after));
+
+            _mm_storeu_si128((__m128i *) (data + i), _mm_xor_si128(block, _mm_and_si128(letters, flip)));
+        }
+#endif
+
+        for (; i < size; ++i) {
+            if (data[i] >= first && data[i] <= last)
+                data[i] ^= 0x20;
+        }
+    }
+
+    /**
+     * @brief Turns all the ASCII letters of a piece of text into lowercase, in place.
+     * @complexity O(n)
+     * @param data the start of the text
+     * @param size the size of the text
+     */
+    void toLowercase(char *data, size_t size) {
+        flipCase(data, size, 'A', 'Z');
+    }
+
+    /**
+     * @brief Turns all the characters of a string into lowercase.
+     * @complexity O(n)
+     * @param s string to be modified
+     */
+    void toLowercase(std::string &s) {
+        toLowercase(s.data(), s.size());
+    }
+
+    /**
+     * @brief Turns all the ASCII letters of a piece of text into uppercase, in place.
+     * @complexity O(n)
+     * @param data the start of the text
+     * @param size the size of the text
+     */
+    void toUppercase(char *data, size_t size) {
+        flipCase(data, size, 'a', 'z');
+    }
+
+    /**
+     * @brief Turns all the characters of a string into uppercase.
+     * @complexity O(n)
+     * @param s string to be modified
+     */
+    void toUppercase(std::string &s) {
+        toUppercase(s.data(), s.size());
+    }
+}
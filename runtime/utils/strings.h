@@ -0,0 +1,14 @@
+#ifndef HELPY_RUNTIME_STRINGS_H
+#define HELPY_RUNTIME_STRINGS_H
+
+#include <cstddef>
+#include <string>
+
+namespace HelpyRuntime::Utils {
+    void toLowercase(char *data, size_t size);
+    void toLowercase(std::string &s);
+    void toUppercase(char *data, size_t size);
+    void toUppercase(std::string &s);
+}
+
+#endif //HELPY_RUNTIME_STRINGS_H
@@ -0,0 +1,67 @@
+#ifndef HELPY_RUNTIME_TICKS_H
+#define HELPY_RUNTIME_TICKS_H
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace HelpyRuntime::Utils {
+    /**
+     * @brief Reads the time-stamp counter of the processor or, if it has none, the clock. Reading the counter is much
+     * cheaper than reading the clock, so it is used to time events that happen very often.
+     * @return the current time, in ticks
+     */
+    inline uint64_t readTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /**
+     * @brief Converts ticks (see readTicks()) to nanoseconds, by comparing the ticks and the time elapsed since the
+     * converter was created. The longer it exists, the more precise the conversion is.
+     */
+    class TickConverter {
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t startTicks;
+        Clock::time_point startTime;
+
+    /* CONSTRUCTOR */
+    public:
+        TickConverter() : startTicks(readTicks()), startTime(Clock::now()) {}
+
+    /* METHODS */
+    public:
+        /**
+         * @brief Returns the time the converter was created.
+         * @return the time, in ticks
+         */
+        [[nodiscard]] uint64_t origin() const {
+            return startTicks;
+        }
+
+        /**
+         * @brief Computes the duration of a tick.
+         * @return the number of nanoseconds per tick
+         */
+        [[nodiscard]] double nanosecondsPerTick() const {
+#if defined(__x86_64__) || defined(__i386__)
+            uint64_t ticks = readTicks() - startTicks;
+            double nanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - startTime).count();
+
+            return ticks ? nanoseconds / (double) ticks : 1;
+#else
+            return 1;
+#endif
+        }
+    };
+}
+
+#endif //HELPY_RUNTIME_TICKS_H
@@ -0,0 +1,84 @@
+#include "utils.h"
+
+namespace HelpyRuntime::Utils {
+    /**
+     * @brief Creates a fort::char_table that will be used to display information in the terminal.
+     * @param columnNames list containing the name of each column of the table
+     * @return fort::char_table object
+     */
+    fort::char_table createTable(const std::vector<std::string> &columnNames) {
+        fort::char_table table;
+
+        // customize the table
+        table.set_border_style(FT_NICE_STYLE);
+        table.row(0).set_cell_content_text_style(fort::text_style::bold);
+        table.row(0).set_cell_content_fg_color(fort::color::yellow);
+
+        // set the table header
+        table << fort::header;
+        auto it = columnNames.begin();
+
+        for (int i = 0; it != columnNames.end(); ++i) {
+            table << *it++;
+
+            // set the alignment of each column
+            table.column(i).set_cell_text_align(fort::text_align::center);
+        }
+
+        table << fort::endr;
+        return table;
+    }
+
+    /**
+     * @brief Creates a fort::utf8_table that will be used to display information in the terminal.
+     * @param columnNames list containing the name of each column of the table
+     * @return fort::utf8_table object
+     */
+    fort::utf8_table createUTF8Table(const std::vector<std::string> &columnNames) {
+        fort::utf8_table table;
+
+        // customize the table
+        table.set_border_style(FT_NICE_STYLE);
+        table.row(0).set_cell_content_text_style(fort::text_style::bold);
+        table.row(0).set_cell_content_fg_color(fort::color::yellow);
+
+        // set the table header
+        table << fort::header;
+        auto it = columnNames.begin();
+
+        for (int i = 0; it != columnNames.end(); ++i) {
+            table << *it++;
+
+            // set the alignment of each column
+            table.column(i).set_cell_text_align(fort::text_align::center);
+        }
+
+        table << fort::endr;
+        return table;
+    }
+
+    /**
+     * @brief Creates a table that will be output to a Markdown file.
+     * @param columnNames list containing the name of each column of the table
+     * @return string representing a Markdown table
+     */
+    std::string createMDTable(const std::vector<std::string> &columnNames) {
+        size_t numColumns = columnNames.size();
+        if (numColumns == 0) return "";
+
+        std::string table = "|";
+
+        // set the table header
+        for (const std::string &columnName : columnNames)
+            table += ' ' + columnName + " |";
+
+        table += "\n|";
+
+        // set the alignment of each column
+        for (size_t i = 0; i < numColumns; ++i)
+            table += ":-:|";
+
+        table += '\n';
+        return table;
+    }
+}
@@ -0,0 +1,16 @@
+#ifndef HELPY_RUNTIME_UTILS_H
+#define HELPY_RUNTIME_UTILS_H
+
+#include <string>
+#include <vector>
+
+#include "fort.hpp"
+#include "strings.h"
+
+namespace HelpyRuntime::Utils {
+    fort::char_table createTable(const std::vector<std::string> &columnNames);
+    fort::utf8_table createUTF8Table(const std::vector<std::string> &columnNames);
+    std::string createMDTable(const std::vector<std::string> &columnNames);
+}
+
+#endif //HELPY_RUNTIME_UTILS_H
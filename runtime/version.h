@@ -0,0 +1,12 @@
+#ifndef HELPY_RUNTIME_VERSION_H
+#define HELPY_RUNTIME_VERSION_H
+
+/*
+ * The version of the runtime. Generated code checks the major version, so any change to the public API of
+ * the runtime that breaks previously generated code must bump it.
+ */
+#define HELPY_RUNTIME_VERSION_MAJOR 1
+#define HELPY_RUNTIME_VERSION_MINOR 21
+#define HELPY_RUNTIME_VERSION_PATCH 0
+
+#endif //HELPY_RUNTIME_VERSION_H
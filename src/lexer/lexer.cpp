@@ -76,6 +76,7 @@ namespace Helpy {
                 case '\'' :
                 case '"' :
                 case ')' :
+                case ']' :
                     if (curr == delimiter && !escape) {
                         getNext = false;
                         break;
@@ -158,6 +159,13 @@ namespace Helpy {
                     break;
                 }
 
+                case '[' : {
+                    std::string marker = readString(']');
+                    tokens.emplace_back(TokenType::Marker, initialLine, initialPos, pos, marker);
+
+                    break;
+                }
+
                 case ':' : {
                     Token last = tokens.back();
                     tokens.pop_back();
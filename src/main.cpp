@@ -1,15 +1,64 @@
 #include <cstring>
+#include <vector>
 
 #include "manager/manager.h"
 #include "utils/utils.hpp"
 
+/**
+ * @brief Parses the arguments of the 'run' command, which are the (optional) path to the Helpyfile and output
+ * directory, followed or preceded by any of the options below.
+ *
+ * --shard-size <n>    distributes the user methods across source files with roughly n commands each
+ * --profile <file>    orders the dispatch of the commands according to a recorded usage profile
+ * --hot-menu          lists the most used commands first in the guided mode (requires --profile)
+ * --backend <name>    selects the I/O backend of the generated code: 'iostream' (default) or 'lite'
+ * --stats             records the latency of each command, which the built-in command 'stats' displays
+ * --plugins           builds each shard (by default, each command) as a plugin, which is loaded when first executed
+ */
+static void run(int argc, char *argv[]) {
+    std::vector<std::string> paths;
+    Helpy::WriterOptions options;
+
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "--shard-size")) {
+            if (++i == argc || (options.shardSize = strtoul(argv[i], nullptr, 10)) == 0)
+                Helpy::Utils::printError("The shard size must be a positive integer!");
+        }
+        else if (!strcmp(argv[i], "--profile")) {
+            if (++i == argc)
+                Helpy::Utils::printError("No profile was specified!");
+
+            options.profile = argv[i];
+        }
+        else if (!strcmp(argv[i], "--hot-menu"))
+            options.hotMenu = true;
+        else if (!strcmp(argv[i], "--backend")) {
+            if (++i == argc || (strcmp(argv[i], "iostream") != 0 && strcmp(argv[i], "lite") != 0))
+                Helpy::Utils::printError("The backend must be either 'iostream' or 'lite'!");
+
+            options.lite = !strcmp(argv[i], "lite");
+        }
+        else if (!strcmp(argv[i], "--stats"))
+            options.stats = true;
+        else if (!strcmp(argv[i], "--plugins"))
+            options.plugins = true;
+        else
+            paths.emplace_back(argv[i]);
+    }
+
+    if (options.hotMenu && options.profile.empty())
+        Helpy::Utils::printError("The --hot-menu option requires a profile!");
+
+    Helpy::Manager::run(paths.empty() ? "" : paths[0], (paths.size() < 2) ? "Helpyfile" : paths[1], options);
+}
+
 int main(int argc, char *argv[]) {
     if (argc < 2) return 0;
 
     if (!strcmp(argv[1], "init"))
         Helpy::Manager::init((argc < 3) ? "helpy" : argv[2]);
     else if (!strcmp(argv[1], "run"))
-        Helpy::Manager::run((argc < 3) ? "" : argv[2], (argc < 4) ? "Helpyfile" : argv[3]);
+        run(argc, argv);
     else
         Helpy::Utils::printError((std::string) "Undefined command '" + argv[1] + "'!");
 
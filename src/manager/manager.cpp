@@ -101,6 +101,9 @@ namespace Helpy {
              << "(eg: - RUN SORTING ALGORITHM).\n"
              << "\n"
              << "Note: Commands are case insensitive.\n"
+             << "\n"
+             << "Commands that take long to execute can be run in the background, so the user can keep\n"
+             << "typing commands, by adding the ASYNC marker (eg: - RUN SORTING ALGORITHM [ASYNC]).\n"
              << "*/\n"
              << "COMMANDS:\n"
              << "- // write your command here\n";
@@ -119,8 +122,9 @@ namespace Helpy {
      * @brief Creates a new Helpy instance according to a Helpyfile.
      * @param path path to either the Helpyfile or the directory where it is stored
      * @param outputDir path where the files pertaining to Helpy will be output
+     * @param options options that customize the generated code
      */
-    void Manager::run(std::string path, std::string outputDir) {
+    void Manager::run(std::string path, std::string outputDir, const WriterOptions &options) {
         // verify if the user input the path to a directory
         if (std::filesystem::is_directory(path)) {
             formatDirname(path);
@@ -176,6 +180,6 @@ namespace Helpy {
 
         // write the Helpy instance
         if (createDirectory(outputDir))
-            Writer(outputDir, info).execute();
+            Writer(outputDir, info, options).execute();
     }
 }
@@ -3,6 +3,8 @@
 
 #include <string>
 
+#include "../writer/writer.h"
+
 namespace Helpy {
     class Manager {
     /* METHODS */
@@ -14,7 +16,7 @@ namespace Helpy {
 
     public:
         static void init(std::string outputDir);
-        static void run(std::string path, std::string outputDir);
+        static void run(std::string path, std::string outputDir, const WriterOptions &options = {});
     };
 }
 
@@ -65,9 +65,13 @@ namespace Helpy {
                 Utils::printError("Not all commands have the same number of arguments - "
                     "they should all have " + std::to_string(numArguments) + '!', it->line);
 
-            // check if there is a description
-            if (it->type == TokenType::String)
-                command.setDescription((it++)->value);
+            // check if there is a description and/or markers
+            while (it != tokens.end() && (it->type == TokenType::String || it->type == TokenType::Marker)) {
+                if (it->type == TokenType::String)
+                    command.setDescription((it++)->value);
+                else
+                    parseMarker(command);
+            }
 
             commands.push_back(command);
         }
@@ -101,6 +105,39 @@ namespace Helpy {
         }
     }
 
+    /**
+     * @brief Parses a marker of a command, which changes how it is executed. The available markers are:
+     * - [ASYNC], which runs the command in the background in the advanced mode;
+     * - [COROUTINE], which turns the command into a C++20 coroutine that reads its input with co_await (see
+     * HelpyRuntime::InputSession);
+     * - [CACHED], which caches the output of the command, along with the input it reads, so it is not executed again
+     * for the same input, even after the program restarts (see HelpyRuntime::ResultCache).
+     * @param command the command the marker belongs to
+     */
+    void Parser::parseMarker(Command &command) {
+        unsigned line = it->line;
+        std::string marker = (it++)->value;
+
+        // convert the marker to uppercase
+        for (char &c : marker)
+            c = (char) toupper(c);
+
+        if (marker == "ASYNC")
+            command.setAsync(true);
+        else if (marker == "COROUTINE")
+            command.setCoroutine(true);
+        else if (marker == "CACHED")
+            command.setCached(true);
+        else
+            Utils::printError("Unknown marker '" + std::string(BOLD) + '[' + marker + ']' + R_BOLD + "'!", line);
+
+        if (command.isAsync() && command.isCoroutine())
+            Utils::printError("A command cannot be both ASYNC and a COROUTINE!", line);
+
+        if (command.isCached() && (command.isAsync() || command.isCoroutine()))
+            Utils::printError("A CACHED command cannot be ASYNC or a COROUTINE!", line);
+    }
+
     std::string Parser::parseName() {
         std::string name = "Helpy";
         unsigned line = (it++)->line;
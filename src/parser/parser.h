@@ -27,6 +27,7 @@ namespace Helpy {
         std::string parseColor();
         std::vector<Command> parseCommands(unsigned &numArguments);
         void parseDescriptions(std::vector<Command> &commands);
+        void parseMarker(Command &command);
         std::string parseName();
 
     public:
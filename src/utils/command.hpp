@@ -10,11 +10,14 @@ namespace Helpy {
         std::string name;
         std::string signature;
         std::string description;
-        unsigned value;
+        long long value;
+        bool async;
+        bool coroutine;
+        bool cached;
 
     /* CONSTRUCTOR */
     public:
-        Command() : value(0) {}
+        Command() : value(0), async(false), coroutine(false), cached(false) {}
 
     /* METHODS */
     public:
@@ -44,11 +47,23 @@ namespace Helpy {
             description = newDescription;
         }
 
+        void setAsync(bool newAsync) {
+            async = newAsync;
+        }
+
+        void setCoroutine(bool newCoroutine) {
+            coroutine = newCoroutine;
+        }
+
+        void setCached(bool newCached) {
+            cached = newCached;
+        }
+
         const std::string& operator[](int index) const {
             return arguments[index];
         }
 
-        void operator+=(unsigned val) {
+        void operator+=(long long val) {
             value += val;
         }
 
@@ -64,9 +79,21 @@ namespace Helpy {
             return description;
         }
 
-        [[nodiscard]] unsigned getValue() const {
+        [[nodiscard]] long long getValue() const {
             return value;
         }
+
+        [[nodiscard]] bool isAsync() const {
+            return async;
+        }
+
+        [[nodiscard]] bool isCoroutine() const {
+            return coroutine;
+        }
+
+        [[nodiscard]] bool isCached() const {
+            return cached;
+        }
     };
 }
 
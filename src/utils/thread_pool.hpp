@@ -0,0 +1,162 @@
+#ifndef HELPY_THREAD_POOL_HPP
+#define HELPY_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Helpy {
+    /**
+     * @brief A pool of threads that execute tasks.
+     *
+     * Each thread has its own queue of tasks. Tasks are distributed among the queues in a round-robin fashion
+     * and, when its queue is empty, a thread steals tasks from the other queues, so that uneven tasks still keep
+     * every thread busy.
+     */
+    class ThreadPool {
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+        std::atomic<size_t> next;
+
+        std::mutex mutex;
+        std::condition_variable available, finished;
+        size_t queued, pending;
+        bool stop;
+
+    /* CONSTRUCTOR */
+    public:
+        /**
+         * @brief Creates a pool with as many threads as the hardware supports.
+         */
+        ThreadPool() : next(0), queued(0), pending(0), stop(false) {
+            unsigned numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+            for (unsigned i = 0; i < numThreads; ++i)
+                queues.push_back(std::make_unique<Queue>());
+
+            for (unsigned i = 0; i < numThreads; ++i)
+                threads.emplace_back(&ThreadPool::work, this, i);
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+
+    /* DESTRUCTOR */
+    public:
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+
+            available.notify_all();
+
+            for (std::thread &thread : threads)
+                thread.join();
+        }
+
+    /* METHODS */
+    private:
+        /**
+         * @brief Removes a task from a queue.
+         * @param index index of the queue
+         * @param steal boolean indicating if the task is being stolen, in which case it is taken from the front
+         * @param task variable which will store the task
+         * @return 'true' if a task was removed, 'false' if the queue is empty
+         */
+        bool pop(size_t index, bool steal, std::function<void()> &task) {
+            Queue &queue = *queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (queue.tasks.empty()) return false;
+
+            if (steal) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            else {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief Executes tasks until the pool is destroyed.
+         * @param index index of the queue of the thread
+         */
+        void work(size_t index) {
+            size_t numQueues = queues.size();
+
+            for (;;) {
+                std::function<void()> task;
+                bool found = pop(index, false, task);
+
+                for (size_t i = 1; !found && i < numQueues; ++i)
+                    found = pop((index + i) % numQueues, true, task);
+
+                if (!found) {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    available.wait(lock, [this] { return stop || queued; });
+
+                    if (stop && !queued) return;
+                    continue;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    --queued;
+                }
+
+                task();
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!--pending) finished.notify_all();
+            }
+        }
+
+    public:
+        /**
+         * @brief Adds a task to the pool.
+         * @param task task to be executed
+         */
+        void submit(std::function<void()> task) {
+            Queue &queue = *queues[next++ % queues.size()];
+
+            // count the task before it can be executed
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++queued;
+                ++pending;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(std::move(task));
+            }
+
+            available.notify_one();
+        }
+
+        /**
+         * @brief Waits until all the submitted tasks have been executed.
+         */
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this] { return !pending; });
+        }
+    };
+}
+
+#endif //HELPY_THREAD_POOL_HPP
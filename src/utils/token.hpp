@@ -15,6 +15,7 @@ namespace Helpy {
         Hyphen, /**< a hyphen */
         Word, /**< a single word */
         String, /**< a string, which can be comprised of many words */
+        Marker, /**< a marker of a command, enclosed in square brackets (e.g. '[ASYNC]') */
 
         // keywords
         ColorKeyword, /**< the string 'COLOR' */
@@ -67,6 +68,9 @@ namespace Helpy {
                 case TokenType::String:
                     os << "String";
                     break;
+                case TokenType::Marker:
+                    os << "Marker";
+                    break;
                 case TokenType::ColorKeyword:
                     os << "COLOR";
                     break;
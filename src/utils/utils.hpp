@@ -1,8 +1,10 @@
 #ifndef HELPY_UTILS_HPP
 #define HELPY_UTILS_HPP
 
-#include <cmath>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 
 // output formatting
@@ -67,30 +69,82 @@ namespace Helpy::Utils {
     }
 
     /**
-     * @brief Computes the first prime number that comes after the argument number.
-     * @param n variable which will store the first prime that comes after its initial value
+     * @brief Escapes a string so that it can be written inside a C++ string literal.
+     * @param string string to be escaped
+     * @return escaped string
      */
-    static void nextPrime(int &n) {
-        if (n < 2) {
-            n = 2;
-            return;
+    static std::string escape(const std::string &string) {
+        std::string string_;
+
+        for (char c : string) {
+            switch (c) {
+                case '\n' :
+                    string_ += "\\n";
+                    break;
+                case '\t' :
+                    string_ += "\\t";
+                    break;
+                case '"' :
+                case '\\' :
+                    string_ += '\\';
+                default :
+                    string_ += c;
+            }
         }
 
-        n += (n % 2) ? 2 : 1;
+        return string_;
+    }
 
-        while (true) {
-            bool isPrime = true;
+    /**
+     * @brief Computes the 32-bit FNV-1a hash of a string.
+     * @param string string to be hashed
+     * @return hash of the string
+     */
+    static uint32_t hash(const std::string &string) {
+        uint32_t hash = 2166136261u;
 
-            for (int i = 3; i < sqrt(n); ++i) {
-                if (n % i) continue;
+        for (char c : string) {
+            hash ^= (unsigned char) c;
+            hash *= 16777619u;
+        }
 
-                isPrime = false;
-                break;
-            }
+        return hash;
+    }
 
-            if (isPrime) break;
-            n += 2;
+    /**
+     * @brief Computes the signature of a word, i.e. the number of occurrences of each of 16 classes of characters
+     * (saturated at 15), stored in 4 bits each. It must match HelpyRuntime::CommandTrie::signature(), which uses it to
+     * discard keywords that are too different from a mistyped word.
+     * @param word the word
+     * @return signature of the word
+     */
+    static uint64_t signature(const std::string &word) {
+        uint64_t signature = 0;
+
+        for (char c : word) {
+            int shift = (c & 15) * 4;
+            if (((signature >> shift) & 15) < 15) signature += (uint64_t) 1 << shift;
+        }
+
+        return signature;
+    }
+
+    /**
+     * @brief Writes a file, unless it already has the specified contents.
+     * @param path path to the file
+     * @param contents contents of the file
+     */
+    static void writeFile(const std::string &path, const std::string &contents) {
+        std::ifstream in(path, std::ios::binary);
+
+        if (in) {
+            std::ostringstream current;
+            current << in.rdbuf();
+
+            if (current.str() == contents) return;
         }
+
+        std::ofstream(path, std::ios::binary) << contents;
     }
 }
 
@@ -1,16 +1,269 @@
 #include "writer.h"
 
-#include <thread>
+#include <algorithm>
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
 
 #include "../utils/utils.hpp"
 
+#define uSet std::unordered_set
+
+// the major version of the Helpy runtime the generated code is written against
+#define RUNTIME_VERSION_MAJOR 1
+
+// the maximum size of a shard, relative to the average size
+#define MAX_SHARD_FACTOR 4
+
+// the percentage of the recorded executions covered by the commands that are considered hot
+#define HOT_COVERAGE 90
+
+// the number of elements (e.g. commands) of each chunk of code that is written in parallel
+#define CHUNK_SIZE 4096
+
+// the I/O backends
+static const Helpy::Backend IOSTREAM = {
+    "helpy_runtime.h", "HelpyRuntime::Console", "std::cout", "std::cerr", "std::cin", "std::endl"
+};
+
+static const Helpy::Backend LITE = {
+    "helpy_runtime_lite.h", "HelpyRuntime::Lite::Console", "IO::out", "IO::err", "IO::in", "IO::endl"
+};
+
+/**
+ * @brief Writes the prototype of the entry point of a command that is built as a plugin, which calls the command.
+ * @param out the stream
+ * @param classname the name of the generated class
+ * @param command the command
+ */
+static void writePluginPrototype(std::ostream &out, const std::string &classname, const Helpy::Command &command) {
+    out << (command.isCoroutine() ? "HelpyRuntime::Task<> " : "void ") << "helpy_plugin_" << command.getSignature()
+        << '(' << classname << " &self";
+
+    if (command.isAsync())
+        out << ", const HelpyRuntime::StopToken &stop";
+    else if (command.isCoroutine())
+        out << ", HelpyRuntime::InputSession &input";
+
+    out << ')';
+}
+
 namespace Helpy {
-    Writer::Writer(const std::string &path, ParserInfo info) : info(std::move(info)) {
-        header = std::ofstream(path + this->info.filename + ".h");
-        source = std::ofstream(path + this->info.filename + ".cpp");
-        utils = std::ofstream(path + this->info.filename + "_utils.hpp");
+    Writer::Writer(std::string path, ParserInfo info, WriterOptions options)
+        : path(std::move(path)), info(std::move(info)), options(options), backend(options.lite ? LITE : IOSTREAM) {
+        async = std::any_of(this->info.commands.begin(), this->info.commands.end(), [](const Command &command) {
+            return command.isAsync();
+        });
+
+        coroutines = std::any_of(this->info.commands.begin(), this->info.commands.end(), [](const Command &command) {
+            return command.isCoroutine();
+        });
+
+        cached = std::any_of(this->info.commands.begin(), this->info.commands.end(), [](const Command &command) {
+            return command.isCached();
+        });
+
+        readProfile();
+        orderCommands();
+    }
+
+    /**
+     * @brief Reads the usage profile, which contains the number of times each command was executed.
+     */
+    void Writer::readProfile() {
+        usage.assign(info.commands.size(), 0);
+        if (options.profile.empty()) return;
+
+        std::ifstream file(options.profile);
+
+        if (!file.is_open())
+            Utils::printError((std::string) "Could not find the profile '" + BOLD + ITALICS + options.profile
+                + RESET + "'! Please verify if the specified path is correct.");
 
-        maps.resize(this->info.numArguments);
+        uMap<std::string, uint64_t> profile;
+
+        for (std::string line; getline(file, line); ) {
+            if (line.empty() || line.front() == '#') continue;
+
+            size_t space = line.find(' ');
+            if (space == std::string::npos) continue;
+
+            profile[line.substr(space + 1)] += strtoull(line.c_str(), nullptr, 10);
+        }
+
+        for (size_t i = 0; i < info.commands.size(); ++i) {
+            auto it = profile.find(info.commands[i].getName());
+            if (it != profile.end()) usage[i] = it->second;
+        }
+    }
+
+    /**
+     * @brief Orders the commands by how often they are used.
+     *
+     * The most used commands, which together account for (at least) HOT_COVERAGE percent of the recorded
+     * executions, are marked as hot. Commands with the same usage keep the order of the Helpyfile.
+     */
+    void Writer::orderCommands() {
+        size_t numCommands = info.commands.size();
+
+        menuOrder.resize(numCommands);
+        for (size_t i = 0; i < numCommands; ++i)
+            menuOrder[i] = (int) i;
+
+        dispatchOrder = menuOrder;
+        std::stable_sort(dispatchOrder.begin(), dispatchOrder.end(), [this](int lhs, int rhs) {
+            return usage[lhs] > usage[rhs];
+        });
+
+        if (options.hotMenu)
+            menuOrder = dispatchOrder;
+
+        menuNumbers.resize(numCommands);
+        for (size_t i = 0; i < numCommands; ++i)
+            menuNumbers[menuOrder[i]] = (int) i + 1;
+
+        // mark the hot commands
+        hot.assign(numCommands, false);
+
+        uint64_t total = 0, acc = 0;
+        for (uint64_t count : usage)
+            total += count;
+
+        for (int i : dispatchOrder) {
+            if (!usage[i] || acc * 100 >= total * HOT_COVERAGE) break;
+
+            hot[i] = true;
+            acc += usage[i];
+        }
+    }
+
+    /**
+     * @brief Assigns a value to each keyword and, consequently, to each command.
+     *
+     * The values of the keywords in each argument position are the digits of a mixed-radix number, so the sum
+     * of the values of the arguments identifies a command without collisions. The digit 0 is reserved for
+     * unknown words, which thus never add up to the value of a command.
+     */
+    void Writer::assignValues() {
+        maps.resize(info.numArguments);
+        keywords.resize(info.numArguments);
+
+        long long weight = 1;
+
+        for (int i = 0; i < info.numArguments; ++i) {
+            uMap<std::string, uint64_t> keywordUsage;
+
+            for (size_t j = 0; j < info.commands.size(); ++j) {
+                Command &command = info.commands[j];
+                const std::string &argument = command[i];
+
+                // new argument
+                if (maps[i].insert({argument, (long long) (keywords[i].size() + 1) * weight}).second)
+                    keywords[i].push_back(argument);
+
+                command += maps[i][argument];
+                keywordUsage[argument] += usage[j];
+            }
+
+            if (weight > LLONG_MAX / (long long) (keywords[i].size() + 1))
+                Utils::printError("There are too many distinct keywords to identify every command!");
+
+            weight *= (long long) keywords[i].size() + 1;
+
+            /*
+             * Colliding keys are chained at the front of their bucket, so the most used keywords are inserted last
+             * in order to be found with fewer probes.
+             */
+            std::stable_sort(keywords[i].begin(), keywords[i].end(), [&keywordUsage](const auto &lhs, const auto &rhs) {
+                return keywordUsage[lhs] < keywordUsage[rhs];
+            });
+        }
+    }
+
+    /**
+     * @brief Distributes the user methods across several source files (shards), so they can be compiled in parallel.
+     *
+     * The boundaries between shards are chosen according to the hash of the signature of each command, which
+     * means that adding or removing a command only changes the shard it belongs to. For the same reason, each
+     * shard is named after the hash of its first command. Each shard is built as a plugin if plugins are enabled, in
+     * which case there is one shard per command unless the shard size is specified.
+     */
+    void Writer::partitionShards() {
+        unsigned shardSize = options.shardSize ? options.shardSize : 1;
+        unsigned size = shardSize;
+
+        for (size_t i = 0; i < info.commands.size(); ++i) {
+            uint32_t hash = Utils::hash(info.commands[i].getSignature());
+
+            // start a new shard
+            if (shards.empty() || !(hash % shardSize) || size >= MAX_SHARD_FACTOR * shardSize) {
+                char id[9];
+                snprintf(id, sizeof(id), "%08x", hash);
+
+                shards.emplace_back(info.filename + (options.plugins ? "_plugin_" : "_shard_") + id + ".cpp", "");
+                shardStarts.push_back(i);
+
+                size = 0;
+            }
+
+            ++size;
+        }
+
+        shardStarts.push_back(info.commands.size());
+    }
+
+    /**
+     * @brief Writes the statement that calls a command, which runs the coroutines with an input session named 'input'.
+     * If the command is built as a plugin, it is called through the dispatch table of the plugins, which loads the
+     * plugin the first time.
+     * @param index the index of the command
+     * @param args the arguments of the command, separated by commas
+     * @return the statement, without the semicolon
+     */
+    std::string Writer::callCommand(size_t index, const std::string &args) {
+        const Command &command = info.commands[index];
+
+        if (!options.plugins) {
+            std::string call = command.getSignature() + '(' + args + ')';
+            return command.isCoroutine() ? "input.run(" + call + ')' : call;
+        }
+
+        std::string type = command.isCoroutine() ? "HelpyRuntime::Task<> (*)(" : "void (*)(";
+        type += info.classname + " &";
+
+        if (command.isAsync())
+            type += ", const HelpyRuntime::StopToken &";
+        else if (command.isCoroutine())
+            type += ", HelpyRuntime::InputSession &";
+
+        std::string call = "command(*this" + (args.empty() ? "" : ", " + args) + ')';
+
+        return "if (auto command = loadPlugin<" + type + ")>(pluginTable, " + std::to_string(index) + ")) "
+            + (command.isCoroutine() ? "input.run(" + call + ')' : call);
+    }
+
+    /**
+     * @brief Splits a section of the code into chunks, which are written by the thread pool.
+     *
+     * The chunks are stored in order, so the section is obtained by concatenating them once the pool finishes.
+     * @param chunks vector which will store the code of each chunk
+     * @param size the number of elements (e.g. commands) of the section
+     * @param write function that writes the elements in the range [begin, end) to a stream
+     */
+    template <typename F>
+    void Writer::writeChunks(std::vector<std::string> &chunks, size_t size, F write) {
+        chunks.resize((size + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            pool.submit([&chunks, i, size, write] {
+                std::ostringstream out;
+                size_t begin = i * CHUNK_SIZE;
+
+                write(out, begin, std::min(begin + CHUNK_SIZE, size));
+                chunks[i] = out.str();
+            });
+        }
     }
 
     void Writer::writeHeaderGuards() {
@@ -21,141 +274,433 @@ namespace Helpy {
 
         header << "#ifndef " << uppercaseFilename << "_H\n"
                << "#define " << uppercaseFilename << "_H\n";
-
-        utils << "#ifndef " << uppercaseFilename << "_UTILS_H\n"
-              << "#define " << uppercaseFilename << "_UTILS_H\n";
     }
 
     void Writer::writeIncludes() {
-        utils << '\n'
-              << "#include <filesystem>\n"
-              << "#include <iostream>\n"
-              << "#include <sstream>\n"
-              << "#include <string>\n"
-              << "#include <unordered_map>\n"
-              << "#include <unordered_set>\n"
-              << "#include <vector>\n"
-              << '\n'
-              << "#include \"../external/libfort/fort.hpp\"\n"
-              << '\n'
-              << "#define uMap std::unordered_map\n"
-              << "#define uSet std::unordered_set\n";
+        header << '\n'
+               << "#include <cstdlib>\n"
+               << (options.lite ? "" : "#include <iostream>\n")
+               << "#include <string>\n"
+                  "#include <string_view>\n"
+                  "#include <unordered_map>\n"
+                  "#include <unordered_set>\n"
+                  "#include <vector>\n"
+               << '\n'
+               << "#include \"" << backend.runtime << "\"\n"
+               << '\n'
+               << "#if HELPY_RUNTIME_VERSION_MAJOR != " << RUNTIME_VERSION_MAJOR << "\n"
+                  "#error \"This file was generated for version " << RUNTIME_VERSION_MAJOR << " of the Helpy runtime!\"\n"
+                  "#endif\n";
+
+        if (coroutines) {
+            header << '\n'
+                   << "#ifndef __cpp_impl_coroutine\n"
+                      "#error \"The commands marked as COROUTINE require C++20!\"\n"
+                      "#endif\n";
+        }
 
         header << '\n'
-               << "#include \"" << info.filename << "_utils.hpp\"\n";
+               << "#define uMap std::unordered_map\n"
+                  "#define uSet std::unordered_set\n"
+               << '\n'
+               << "namespace Utils = HelpyRuntime::Utils;\n";
+
+        if (options.lite)
+            header << "namespace IO = HelpyRuntime::IO;\n";
 
-        source << "#include \"" << info.filename << ".h\"\n";
     }
 
-    void Writer::writeMethodsDeclaration() {
+    void Writer::writeMethodsDeclaration(std::ostream &out, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const Command &command = info.commands[i];
+
+            if (command.isCoroutine()) {
+                out << "\tHelpyRuntime::Task<> " << command.getSignature() << "(HelpyRuntime::InputSession &input);\n";
+                continue;
+            }
+
+            out << "\tvoid " << command.getSignature()
+                << (command.isAsync() ? "(const HelpyRuntime::StopToken &stop);\n" : "();\n");
+        }
+    }
+
+    /**
+     * @brief Declares the entry points of the commands that are built as plugins, which the generated class befriends.
+     */
+    void Writer::writePluginDeclarations() {
+        header << '\n'
+               << "class " << info.classname << ";\n"
+                  "\n"
+                  "// the entry points of the commands, which are defined by the plugins (see HelpyRuntime::PluginTable)\n"
+                  "extern \"C\" {\n";
+
+        for (const Command &command : info.commands) {
+            writePluginPrototype(header, info.classname, command);
+            header << ";\n";
+        }
+
+        header << "}\n";
+    }
+
+    void Writer::writeClass() {
+        header << '\n'
+               << "class " << info.classname << " : public " << backend.console << " {\n"
+               << "\tstatic uMap<std::string_view, long long> ";
+
+        for (int i = 1; i <= info.numArguments; ++i)
+            header << "map" << i << ((i < info.numArguments) ? ", " : ";\n");
+
+        header << "\tHelpyRuntime::UsageRecorder usageRecorder;\n";
+
+        if (options.stats)
+            header << "\tHelpyRuntime::LatencyStats latencyStats;\n";
+
+        if (cached)
+            header << "\tHelpyRuntime::ResultCache resultCache;\n";
+
+        if (options.plugins)
+            header << "\tHelpyRuntime::PluginTable pluginTable;\n";
+
         // user-defined methods
         header << "\n"
                   "\t/* METHODS */\n"
                   "\t// commands\n";
 
-        for (const Command &command : info.commands)
-            header << "\tvoid " << command.getSignature() << "();\n";
+        for (const std::string &chunk : declarations)
+            header << chunk;
+
+        if (options.plugins) {
+            header << "\n"
+                      "\t// the entry points of the plugins, which call the commands\n";
+
+            for (const Command &command : info.commands) {
+                header << "\tfriend ";
+                writePluginPrototype(header, info.classname, command);
+                header << ";\n";
+            }
+        }
 
         // Helpy methods
         header << "\n"
                   "\t// DO NOT ALTER THE DECLARATIONS BELOW!\n"
-                  "\tstatic std::string readInput(const std::string &instruction, bool caseSensitive = false);\n"
-                  "\tstatic std::string readInput(const std::string &instruction, const std::vector<std::string> &options);\n"
-                  "\tstatic bool readYesOrNo(const std::string &instruction, bool strict = false);\n"
-                  "\tstatic double readNumber(const std::string &instruction);\n"
-                  "\tstatic double readNumber(const std::string &instruction, double minimum, double maximum);\n"
-                  "\tstatic double readNumber(const std::string &instruction, const std::vector<double> &options);\n"
-                  "\tstatic std::string readFilename(const std::string &instruction);\n"
-                  "\tstatic std::string readDirname(const std::string &instruction);\n"
-                  "\tstatic std::vector<std::string> readCSV(const std::string &instruction, char delimiter = ',');\n"
-                  "\n"
-                  "\tbool executeCommand(int value);\n"
-                  "\tvoid advancedMode();\n"
-                  "\tvoid guidedMode();\n";
+                  "\tbool executeCommand(long long value"
+               << (async ? ", HelpyRuntime::JobPool::Handle *job = nullptr" : "") << ");\n"
+               << "\tvoid advancedMode();\n"
+                  "\tbool benchCommand(const std::string_view *words, size_t numWords);\n"
+                  "\tstatic long long resolveCommand(const std::string_view *words, size_t numWords);\n"
+                  "\tvoid guidedMode();\n"
+                  "\tint runScript(const char *path, bool timings);\n"
+                  "\tbool executeLine(std::string_view line);\n";
 
         header << '\n'
                << "public:\n"
-               << "\tvoid run();\n";
+               << "\t" << info.classname << "();\n"
+               << "\tvoid run();\n"
+               << "\tint run(int argc, char **argv);\n"
+               << "};\n";
     }
 
-    void Writer::writeClass() {
-        header << '\n'
-               << "class " << info.classname << " {\n"
-               << "\tstatic uMap<std::string, int> ";
+    void Writer::writeMacros(std::ostream &out) {
+        out << '\n'
+            << "// formatting\n"
+               "#define RESET        \"\\033[0m\"\n"
+               "#define BOLD         \"\\033[1m\"\n"
+               "#define ITALICS      \"\\033[3m\"\n"
+               "#define UNDERLINE    \"\\033[4m\"\n"
+            << '\n'
+            << "// output colors\n"
+               "#define RED          \"\\033[31m\"\n"
+               "#define GREEN        \"\\033[32m\"\n"
+               "#define YELLOW       \"\\033[33m\"\n"
+               "#define BLUE         \"\\033[34m\"\n"
+               "#define PURPLE       \"\\033[35m\"\n"
+               "#define CYAN         \"\\033[36m\"\n"
+               "#define WHITE        \"\\033[37m\"\n"
+            << '\n'
+            << "// text\n"
+               "#define DASHED_LINE  \"- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -\"\n"
+               "#define BREAK        '\\n' << " << info.color << " << DASHED_LINE << RESET << '\\n' << " << backend.endl << "\n"
+               "#define YES_NO       std::string(\" (\") + GREEN + \"Yes\" + RESET + \"/\" + RED + \"No\" + RESET + \")\"\n"
+            << '\n'
+            << "// branch prediction\n"
+               "#if __has_cpp_attribute(likely)\n"
+               "#define LIKELY       [[likely]]\n"
+               "#else\n"
+               "#define LIKELY\n"
+               "#endif\n";
+    }
 
-        for (int i = 1; i <= info.numArguments; ++i)
-            header << "map" << i << ((i < info.numArguments) ? ", " : ";\n");
+    void Writer::writeKeywordMap(std::ostream &out, int position) {
+        out << "uMap<std::string_view, long long> " << info.classname << "::map" << position + 1 << " = {";
+
+        for (const std::string &keyword : keywords[position])
+            out << "{\"" << keyword << "\", " << maps[position].at(keyword) << "},";
 
-        writeMethodsDeclaration();
-        header << "};\n";
+        out << "};\n";
     }
 
-    void Writer::writeMacros() {
-        source << '\n'
-               << "// formatting\n"
-                  "#define RESET        \"\\033[0m\"\n"
-                  "#define BOLD         \"\\033[1m\"\n"
-                  "#define ITALICS      \"\\033[3m\"\n"
-                  "#define UNDERLINE    \"\\033[4m\"\n"
-               << '\n'
-               << "// output colors\n"
-                  "#define RED          \"\\033[31m\"\n"
-                  "#define GREEN        \"\\033[32m\"\n"
-                  "#define YELLOW       \"\\033[33m\"\n"
-                  "#define BLUE         \"\\033[34m\"\n"
-                  "#define PURPLE       \"\\033[35m\"\n"
-                  "#define CYAN         \"\\033[36m\"\n"
-                  "#define WHITE        \"\\033[37m\"\n"
-               << '\n'
-               << "// text\n"
-                  "#define DASHED_LINE  \"- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -\"\n"
-                  "#define BREAK        '\\n' << " << info.color << " << DASHED_LINE << RESET << '\\n' << std::endl\n"
-                  "#define YES_NO       std::string(\" (\") + GREEN + \"Yes\" + RESET + \"/\" + RED + \"No\" + RESET + \")\"\n";
+    void Writer::writeCommandNames(std::ostream &out, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            out << "\t\"" << info.commands[i].getName() << "\",\n";
     }
 
-    void Writer::writeKeywordMaps() {
-        source << '\n';
-        int prime = 2;
+    /**
+     * @brief Writes the trie of the words of the commands, which the generated code uses to complete commands and to
+     * suggest commands when an unknown one is input. The nodes are numbered in breadth-first order, and the edges of
+     * each node are sorted by word, so the candidates can be found by binary search. The signature of each word is
+     * computed here, so the generated code does not have to.
+     */
+    void Writer::writeCommandTrie(std::ostream &out) {
+        std::vector<size_t> order(info.commands.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+
+        std::sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+            for (int i = 0; i < info.numArguments; ++i) {
+                int comparison = info.commands[lhs][i].compare(info.commands[rhs][i]);
+                if (comparison) return comparison < 0;
+            }
 
-        for (int i = 0; i < info.numArguments; ++i) {
-            source << "uMap<std::string, int> " << info.classname << "::map" << i + 1 << " = {";
+            return false;
+        });
 
-            int value = prime;
-            for (Command &command : info.commands) {
-                const std::string &argument = command[i];
+        // each node is a range of the sorted commands whose first words are the same
+        struct Node {
+            size_t begin, end;
+            int depth;
+        };
 
-                // new argument
-                if (maps[i].insert({argument, value}).second) {
-                    source << "{\"" << command[i] << "\", " << value << "},";
-                    value *= prime;
-                }
+        std::vector<Node> nodes = {{0, order.size(), 0}};
+        std::ostringstream nodesOut, edgesOut;
+        size_t numEdges = 0;
 
-                command += maps[i][argument];
+        for (size_t n = 0; n < nodes.size(); ++n) {
+            Node node = nodes[n];
+            size_t firstEdge = numEdges;
+            bool leaf = node.depth + 1 == info.numArguments;
+
+            for (size_t i = node.begin, j; i < node.end; i = j) {
+                const std::string &word = info.commands[order[i]][node.depth];
+                for (j = i + 1; j < node.end && info.commands[order[j]][node.depth] == word; ++j);
+
+                // the length is explicit, so the compiler does not have to compute it for every keyword
+                char signature[19];
+                snprintf(signature, sizeof(signature), "0x%016llx", (unsigned long long) Utils::signature(word));
+
+                edgesOut << "\t{{\"" << word << "\", " << word.size() << "}, " << (leaf ? 0 : nodes.size()) << ", "
+                         << signature << "},\n";
+                if (!leaf) nodes.push_back({i, j, node.depth + 1});
+
+                ++numEdges;
             }
 
-            source << "};\n";
-            Utils::nextPrime(prime);
+            nodesOut << "\t{" << firstEdge << ", " << numEdges << "},\n";
         }
+
+        out << '\n'
+            << "/**\n"
+               " * @brief The trie of the words of the commands, which is used to complete them as they are typed and to\n"
+               " * suggest commands when an unknown one is input.\n"
+               " */\n"
+            << "static constexpr HelpyRuntime::CommandTrie::Node COMMAND_TRIE_NODES[] = {\n"
+            << nodesOut.str()
+            << "};\n"
+            << '\n'
+            << "static constexpr HelpyRuntime::CommandTrie::Edge COMMAND_TRIE_EDGES[] = {\n"
+            << edgesOut.str()
+            << "};\n";
     }
 
-    void Writer::writeUserMethods() {
-        for (const Command &command : info.commands) {
-            source << '\n'
-                   << "/**\n"
-                   << " * @brief ";
-
-            // write the method description
-            for (const char &c : command.getDescription()) {
-                source << c;
-                if (c == '\n') source << " * ";
+    void Writer::writeUserMethod(std::ostream &out, const Command &command) {
+        out << '\n'
+            << "/**\n"
+            << " * @brief ";
+
+        // write the method description
+        for (const char &c : command.getDescription()) {
+            out << c;
+            if (c == '\n') out << " * ";
+        }
+
+        out << '\n';
+
+        if (command.isAsync()) {
+            out << " * @param stop the token that signals the cancellation of the command, which runs in the background in\n"
+                   " * the advanced mode and should return soon after stop.stopRequested() becomes 'true'\n";
+        }
+
+        if (command.isCoroutine()) {
+            out << " * @param input the input of the command, which is read with co_await, e.g.\n"
+                   " * co_await input.readInteger(\"Enter a number\")\n"
+                   " */\n"
+                << "HelpyRuntime::Task<> " << info.classname << "::" << command.getSignature()
+                << "(HelpyRuntime::InputSession &input) {\n"
+                << "\t" << backend.out << " << BREAK;\n"
+                << "\t" << backend.out << " << \"Under development!\" << " << backend.endl << ";\n"
+                << "\tco_return;\n"
+                << "}\n";
+
+            return;
+        }
+
+        out << " */\n"
+            << "void " << info.classname << "::" << command.getSignature()
+            << (command.isAsync() ? "(const HelpyRuntime::StopToken &stop) {\n" : "() {\n")
+            << "\t" << backend.out << " << BREAK;\n"
+            << "\t" << backend.out << " << \"Under development!\" << " << backend.endl << ";\n"
+            << "}\n";
+    }
+
+    void Writer::writeUserMethods(std::ostream &out, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            writeUserMethod(out, info.commands[i]);
+    }
+
+    void Writer::writeShard(std::ostream &out, size_t index) {
+        out << "#include \"" << info.filename << ".h\"\n";
+        writeMacros(out);
+
+        writeUserMethods(out, shardStarts[index], shardStarts[index + 1]);
+
+        if (!options.plugins) return;
+
+        out << "\n"
+               "// the entry points of the plugin, which the program resolves when the commands are first executed\n";
+
+        for (size_t i = shardStarts[index]; i < shardStarts[index + 1]; ++i) {
+            if (i > shardStarts[index]) out << '\n';
+            writePluginEntry(out, info.commands[i]);
+        }
+    }
+
+    /**
+     * @brief Writes the entry point of a command that is built as a plugin, which the executable resolves by name.
+     * @param out the stream
+     * @param command the command
+     */
+    void Writer::writePluginEntry(std::ostream &out, const Command &command) {
+        out << "extern \"C\" HELPY_PLUGIN_EXPORT ";
+
+        writePluginPrototype(out, info.classname, command);
+
+        out << " {\n"
+               "\t" << (command.isCoroutine() ? "return " : "") << "self." << command.getSignature() << '('
+            << (command.isAsync() ? "stop" : command.isCoroutine() ? "input" : "") << ");\n"
+               "}\n";
+    }
+
+    /**
+     * @brief Writes the plugin and the entry point of each command, which the dispatch table of the plugins loads.
+     */
+    void Writer::writePluginSymbols(std::ostream &out) {
+        out << '\n'
+            << "/**\n"
+               " * @brief The plugin and the entry point of each command, which are loaded when the command is first executed.\n"
+               " */\n"
+            << "static constexpr HelpyRuntime::PluginTable::Symbol PLUGIN_SYMBOLS[] = {\n";
+
+        for (size_t shard = 0; shard + 1 < shardStarts.size(); ++shard) {
+            std::string_view library = shards[shard].first;
+            library.remove_suffix(4); // .cpp
+
+            for (size_t i = shardStarts[shard]; i < shardStarts[shard + 1]; ++i) {
+                out << "\t{\"" << library << "\", \"helpy_plugin_" << info.commands[i].getSignature() << "\"}"
+                    << (i + 1 < info.commands.size() ? ",\n" : "\n");
             }
+        }
 
-            source << '\n'
-                   << " */\n"
-                   << "void " << info.classname << "::" << command.getSignature() << "() {\n"
-                   << "\tstd::cout << BREAK;\n"
-                   << "\tstd::cout << \"Under development!\" << std::endl;\n"
-                   << "}\n";
+        out << "};\n";
+    }
+
+    void Writer::writeGuidedMenu(std::ostream &out, size_t begin, size_t end, bool plain) {
+        size_t numCommands = info.commands.size();
+
+        for (size_t i = begin; i < end; ++i) {
+            const Command &command = info.commands[menuOrder[i]];
+
+            std::string name = Utils::escape(command.getName());
+            std::string description = Utils::escape(command.getDescription());
+
+            bool hasDescription = !description.empty(); // verify if the command has a description
+            bool isLast = i + 1 == numCommands; // verify if we are writing the last command
+
+            if (plain)
+                out << "\t\"" << i + 1 << " - " << name;
+            else
+                out << "\tBOLD " << info.color << " \"" << i + 1 << " - \" WHITE \"" << name;
+
+            switch ((isLast << 1) + hasDescription) {
+                // write command that neither has a description nor is last
+                case 0 :
+                    out << (plain ? "\\n\\n\"\n" : "\\n\" RESET \"\\n\"\n");
+                    break;
+
+                // write command that has a description but is not last
+                case 1 :
+                    if (plain)
+                        out << "\\n" << description << "\\n\\n\"\n";
+                    else
+                        out << "\\n\" RESET ITALICS \"" << description << "\\n\" RESET \"\\n\"\n";
+
+                    break;
+
+                // write the last command (without description)
+                case 2 :
+                    out << (plain ? "\"" : "\" RESET");
+                    break;
+
+                // write the last command (with description)
+                case 3 :
+                    if (plain)
+                        out << "\\n" << description << '"';
+                    else
+                        out << "\\n\" RESET ITALICS \"" << description << "\" RESET";
+
+                    break;
+            }
+        }
+    }
+
+    /**
+     * @brief Writes the cases of the switch that executes the commands, starting with the most used commands. The
+     * commands marked as ASYNC are submitted to the job pool if the caller asks for a job, whereas the commands
+     * marked as COROUTINE are run to completion with a blocking input session. The output of the commands marked as
+     * CACHED is replayed from the result cache, if possible.
+     */
+    void Writer::writeDispatch(std::ostream &out, size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j) {
+            int i = dispatchOrder[j];
+            const Command &command = info.commands[i];
+
+            out << "\t\tcase -" << menuNumbers[i] << " :\n"
+                   "\t\tcase " << command.getValue() << " :" << (hot[i] ? " LIKELY" : "") << "\n"
+                   "\t\t\tusageRecorder.record(" << i << ");\n"
+                   "\t\t\ttrace.split(COMMAND_NAMES[" << i << "]);\n";
+
+            if (command.isAsync()) {
+                out << "\n"
+                       "\t\t\tif (job) *job = submitJob(COMMAND_NAMES[" << i << "], [this](const HelpyRuntime::StopToken &stop) {\n"
+                       "\t\t\t\t" << callCommand(i, "stop") << ";\n"
+                       "\t\t\t});\n"
+                       "\t\t\telse " << callCommand(i, "HelpyRuntime::StopToken()") << ";\n"
+                       "\n";
+            }
+            else if (command.isCoroutine()) {
+                out << "\n"
+                       "\t\t\t{\n"
+                       "\t\t\t\tHelpyRuntime::InputSession input(*this);\n"
+                       "\t\t\t\t" << callCommand(i, "input") << ";\n"
+                       "\t\t\t}\n"
+                       "\n";
+            }
+            else if (command.isCached()) {
+                out << "\t\t\trunCached(resultCache, COMMAND_NAMES[" << i << "], [this] { "
+                    << callCommand(i, "") << "; });\n";
+            }
+            else
+                out << "\t\t\t" << callCommand(i, "") << ";\n";
+
+            out << "\t\t\t" << "break;\n\n";
         }
     }
 
@@ -165,589 +710,714 @@ namespace Helpy {
                   "\tDO NOT ALTER THE METHODS BELOW!\n"
                   " ********************************************************/\n";
 
-        // readInput()
+        // constructor
         source << "\n"
                   "/**\n"
-                  " * @brief Reads a line of user input.\n"
-                  " * @param instruction the instruction that will be displayed before prompting the user to input\n"
-                  " * @param caseSensitive boolean indicating whether the input should be treated as case-sensitive"
-                  " * @return read input\n"
+                  " * @brief Creates the command-line menu.\n"
                   " */\n"
-               << "std::string " << info.classname << "::readInput(const std::string &instruction, bool caseSensitive) {\n"
-                  "\t// display the instruction\n"
-                  "\tstd::cout << BREAK;\n"
-                  "\tstd::cout << instruction << '\\n' << std::endl;\n"
-                  "\n"
-                  "\t// read the user input\n"
-                  "\tstd::string input; getline(std::cin >> std::ws, input);\n"
-                  "\n"
-                  "\t// if the input is NOT case-sensitive, convert it to lowercase\n"
-                  "\tif (!caseSensitive) {\n"
-                  "\t\tUtils::toLowercase(input);\n"
-                  "\t}\n"
-                  "\n"
-                  "\treturn input;\n"
-                  "}\n";
+               << info.classname << "::" << info.classname << "()\n"
+                  "\t: " << backend.console << "(" << info.color << ", {COMMAND_TRIE_NODES, COMMAND_TRIE_EDGES}, \""
+               << info.filename << "\"), usageRecorder(COMMAND_NAMES, " << info.commands.size() << ")";
 
-        // readInput(options)
+        if (options.stats)
+            source << ", latencyStats(COMMAND_NAMES, " << info.commands.size() << ")";
+
+        if (cached)
+            source << ", resultCache(\"" << info.filename << "\")";
+
+        if (options.plugins)
+            source << ", pluginTable(PLUGIN_SYMBOLS, " << info.commands.size() << ")";
+
+        source << " {}\n";
+
+        // executeCommand()
         source << "\n"
                   "/**\n"
-                  " * @brief Reads user input.\n"
-                  " * @param instruction the instruction that will be displayed before prompting the user to input\n"
-                  " * @param options the options that will be displayed to the user\n"
-                  " * @return read input\n"
+                  " * @brief Parses the arguments that were input and executes the corresponding command.\n"
+                  " * @param value the value that will be used in the switch case to choose which command to execute\n";
+
+        if (async) {
+            source << " * @param job pointer to the handle that will store the job of the command, if it runs in the background,\n"
+                      " * or nullptr to run every command in the foreground\n";
+        }
+
+        source << " * @return 'true' if the command exists, 'false' otherwise\n"
+                  " */\n"
+               << "bool " << info.classname << "::executeCommand(long long value"
+               << (async ? ", HelpyRuntime::JobPool::Handle *job" : "") << ") {\n";
+
+        if (options.stats)
+            source << "\tuint64_t start = HelpyRuntime::LatencyStats::now();\n";
+
+        source << "\tHelpyRuntime::TraceScope trace(\"dispatch\"); // the command has a span of its own\n"
+                  "\n";
+
+        source << "\tswitch (value) {\n";
+
+        for (const std::string &chunk : dispatch)
+            source << chunk;
+
+        source << "\t\tdefault :\n"
+               << "\t\t\treturn false;\n"
+               << "\t}\n"
+               << '\n';
+
+        if (options.stats) {
+            source << "\tlatencyStats.record(usageRecorder.last(), start);\n"
+                      "\n";
+        }
+
+        source << "\treturn true;\n"
+               << "}\n";
+
+        // advancedMode()
+        source << '\n'
+               << "/**\n"
+                  " * @brief Executes the advanced mode of the UI.\n";
+
+        if (async) {
+            source << " * The commands marked as ASYNC run in the background, and their jobs are managed with the built-in\n"
+                      " * commands 'jobs', 'wait [id]' and 'cancel [id]'.\n";
+        }
+
+        if (options.stats)
+            source << " * The built-in command 'stats' displays the latency of the commands that were executed.\n";
+
+        if (options.plugins)
+            source << " * The built-in command 'reload' reloads the plugins of the commands, e.g. after they are rebuilt.\n";
+
+        source << " * The built-in command 'bench <command> [iterations]' benchmarks a command (see benchCommand()).\n"
+                  " * A line can also compose several commands, e.g. 'repeat 3 <command> & <command> ; <command>' (see\n"
+                  " * HelpyRuntime::CommandGraph).\n"
                   " */\n"
-               << "std::string " << info.classname << "::readInput(const std::string &instruction, const std::vector<std::string> &options) {\n"
-                  "\tstd::string input;\n"
-                  "\tbool valid = false;\n"
+               << "void " << info.classname << "::advancedMode() {\n"
+                  "\t// the words are views of the line buffer of the console, so reading a command allocates no memory\n"
+                  "\tstd::string_view words[" << info.numArguments + 2 << "];\n"
                   "\n"
-                  "\t// hash the options to achieve better search performance\n"
-                  "\tuSet<std::string> options_(options.begin(), options.end());\n"
+                  "\tfor (;;) {\n";
+
+        if (async) {
+            source << "\t\t// display the jobs that finished in the meantime\n"
+                      "\t\treportJobs();\n"
+                      "\n";
+        }
+
+        source << "\t\tsize_t numWords = readCommand(\"How can I be of assistance?\", words, " << info.numArguments + 2 << ");\n"
                   "\n"
-                  "\tfor (;;) {\n"
-                  "\t\tstd::string line = " << info.classname << "::readInput(instruction);\n"
-                  "\t\tstd::istringstream line_(line);\n"
+                  "\t\tif (!numWords || words[0] == \"quit\" || words[0] == \"no\" || words[0] == \"die\")\n"
+                  "\t\t\tbreak;\n"
+                  "\n"
+                  "\t\t// unknown words are worth 0, so they never add up to the value of a command\n"
+                  "\t\tlong long value = 0;\n"
                   "\n"
-                  "\t\twhile (line_ >> input) {\n"
-                  "\t\t\tif (options_.find(input) == options_.end())\n"
+                  "\t\tif (numWords == " << info.numArguments << ") {\n";
+
+        for (int i = 0; i < info.numArguments; ++i)
+            source << "\t\t\tif (auto it = map" << i + 1 << ".find(words[" << i << "]); it != map" << i + 1 << ".end()) value += it->second;\n";
+
+        source << "\t\t}\n"
+                  "\n";
+
+        if (async) {
+            source << "\t\tHelpyRuntime::JobPool::Handle job;\n"
+                      "\n"
+                      "\t\tif (!executeCommand(value, &job)) {\n"
+                      "\t\t\t// the built-in commands that manage the jobs only run if the words are not a command\n"
+                      "\t\t\tif (runJobCommand(words, numWords))\n"
+                      "\t\t\t\tcontinue;\n"
+                      "\n";
+        }
+        else {
+            source << "\t\tif (!executeCommand(value))\n"
+                      "\t\t{\n";
+        }
+
+        source << "\t\t\t// the built-in command that benchmarks a command only runs if the words are not a command\n"
+                  "\t\t\tif (words[0] == \"bench\" && benchCommand(words + 1, numWords - 1))\n"
                   "\t\t\t\tcontinue;\n"
                   "\n"
-                  "\t\t\tvalid = true;\n"
-                  "\t\t\tbreak;\n"
-                  "\t\t}\n"
+                  "\t\t\t// the lines that compose several commands only run if the words are not a command\n"
+                  "\t\t\tif (runComposite(resolveCommand, [this](long long value) { return executeCommand(value); }))\n"
+                  "\t\t\t\tcontinue;\n"
+                  "\n";
+
+        if (options.stats) {
+            source << "\t\t\t// the built-in command that displays the latency of the commands only runs if the words are not a command\n"
+                      "\t\t\tif (numWords == 1 && words[0] == \"stats\") {\n"
+                      "\t\t\t\t" << backend.out << " << BREAK;\n"
+                      "\t\t\t\t" << backend.out << " << latencyStats.table() << " << backend.endl << ";\n"
+                      "\t\t\t\tcontinue;\n"
+                      "\t\t\t}\n"
+                      "\n";
+        }
+
+        if (options.plugins) {
+            source << "\t\t\t// the built-in command that reloads the plugins only runs if the words are not a command\n"
+                      "\t\t\tif (numWords == 1 && words[0] == \"reload\") {\n"
+                      "\t\t\t\treloadPlugins(pluginTable);\n"
+                      "\t\t\t\tcontinue;\n"
+                      "\t\t\t}\n"
+                      "\n";
+        }
+
+        source << "\t\t\t" << backend.out << " << BREAK;\n"
+                  "\t\t\t" << backend.out << " << RED << \"Invalid command! Please, type another command.\" << RESET << " << backend.endl << ";\n"
                   "\n"
-                  "\t\tif (valid) break;\n"
+                  "\t\t\tif (std::string_view suggestion = suggestCommand(words, numWords); !suggestion.empty())\n"
+                  "\t\t\t\t" << backend.out << " << suggestion << " << backend.endl << ";\n"
+                  "\n"
+                  "\t\t\tcontinue;\n"
+                  "\t\t}\n"
+                  "\n";
+
+        if (async) {
+            source << "\t\t// the commands that run in the background do not hold the prompt\n"
+                      "\t\tif (job)\n"
+                      "\t\t\tcontinue;\n"
+                      "\n";
+        }
+
+        source << "\t\t// ask the user if they want to execute another command\n"
+                  "\t\tif (!" << info.classname << "::readYesOrNo(\"Anything else?\"))\n"
+                  "\t\t\tbreak;\n"
+                  "\t}\n";
+
+        if (async) {
+            source << "\n"
+                      "\t// the jobs may use the object, so they must finish before it is destroyed\n"
+                      "\tfinishJobs();\n";
+        }
+
+        source << "}\n";
+
+        // benchCommand()
+        source << '\n'
+               << "/**\n"
+                  " * @brief Benchmarks a command, which is executed repeatedly with its output discarded, and displays its\n"
+                  " * latency, throughput and heap allocations (see HelpyRuntime::Benchmark). The executions are not recorded\n"
+                  " * as usage of the command.\n"
+                  " * @param words the words of the command, optionally followed by the number of iterations\n"
+                  " * @param numWords the number of words\n"
+                  " * @return 'true' if the words are a command, 'false' otherwise\n"
+                  " */\n"
+               << "bool " << info.classname << "::benchCommand(const std::string_view *words, size_t numWords) {\n"
+                  "\t// if the number of iterations is not specified, the command runs for about a second\n"
+                  "\tsize_t iterations = 0;\n"
                   "\n"
-                  "\t\tstd::cout << BREAK;\n"
-                  "\t\tstd::cout << RED << \"Invalid command! Please, try again.\" << RESET << std::endl;\n"
+                  "\tif (numWords == " << info.numArguments + 1 << ") {\n"
+                  "\t\tif (!Utils::parseNumber(words[" << info.numArguments << "], iterations) || !iterations)\n"
+                  "\t\t\treturn false;\n"
                   "\t}\n"
+                  "\telse if (numWords != " << info.numArguments << ")\n"
+                  "\t\treturn false;\n"
                   "\n"
-                  "\treturn input;\n"
+                  "\t// unknown words are worth 0, so they never add up to the value of a command\n"
+                  "\tlong long value = 0;\n"
+                  "\n";
+
+        for (int i = 0; i < info.numArguments; ++i)
+            source << "\tif (auto it = map" << i + 1 << ".find(words[" << i << "]); it != map" << i + 1 << ".end()) value += it->second;\n";
+
+        source << "\n"
+                  "\tsize_t executions = benchmark([this, value] { return executeCommand(value); }, iterations);\n"
+                  "\tif (!executions)\n"
+                  "\t\treturn false;\n"
+                  "\n"
+                  "\tusageRecorder.discard(usageRecorder.last(), executions);\n"
+                  "\treturn true;\n"
                   "}\n";
 
-        // readYesOrNo()
+        // resolveCommand()
         source << '\n'
                << "/**\n"
-                  " * @brief Reads the user's answer to a Yes/No question.\n"
-                  " * @param instruction the instruction that will be displayed before prompting the user to input\n"
-                  " * @param strict boolean indicating if the user must explicitly type Yes or No\n"
-                  " * @return 'true' if the user answered Yes, 'false' otherwise\n"
+                  " * @brief Resolves the words of a command to its value, which identifies it (see executeCommand()).\n"
+                  " * @param words the words of the command, in lowercase\n"
+                  " * @param numWords the number of words\n"
+                  " * @return the value of the command, or 0 if the words are not a command\n"
                   " */\n"
-               << "bool " << info.classname << "::readYesOrNo(const std::string &instruction, bool strict) {\n"
-                  "\tstd::string input = strict\n"
-                  "\t\t? " << info.classname << "::readInput(instruction + YES_NO, {\"yes\", \"no\", \"y\", \"n\"})\n"
-                  "\t\t: " << info.classname << "::readInput(instruction + YES_NO);\n"
+               << "long long " << info.classname << "::resolveCommand(const std::string_view *words, size_t numWords) {\n"
+                  "\tif (numWords != " << info.numArguments << ")\n"
+                  "\t\treturn 0;\n"
                   "\n"
-                  "\treturn input == \"yes\" || input == \"y\";\n"
+                  "\t// unknown words are worth 0, so they never add up to the value of a command\n"
+                  "\tlong long value = 0;\n"
+                  "\n";
+
+        for (int i = 0; i < info.numArguments; ++i)
+            source << "\tif (auto it = map" << i + 1 << ".find(words[" << i << "]); it != map" << i + 1 << ".end()) value += it->second;\n";
+
+        source << "\n"
+                  "\tswitch (value) {\n";
+
+        for (const Command &command : info.commands)
+            source << "\t\tcase " << command.getValue() << " :\n";
+
+        source << "\t\t\treturn value;\n"
+                  "\n"
+                  "\t\tdefault :\n"
+                  "\t\t\treturn 0;\n"
+                  "\t}\n"
                   "}\n";
 
-        // readNumber()
+        // guidedMode()
         source << '\n'
                << "/**\n"
-                  " * @brief Reads a number from the console.\n"
-                  " * @param instruction the instruction that will be displayed before prompting the user to input the number\n"
-                  " * @return the number input by the user\n"
+                  " * @brief The menu of the guided mode, which is rendered when the code is generated so displaying it\n"
+                  " * requires no allocations. The plain version is used when the output is not a terminal.\n"
                   " */\n"
-               << "double " << info.classname << "::readNumber(const std::string &instruction){\n"
-                  "\tdouble number;\n"
-                  "\tbool valid = false;\n"
-                  "\n"
-                  "\tfor (;;) {\n"
-                  "\t\tstd::cout << BREAK;\n"
-                  "\t\tstd::cout << instruction << '\\n' << std::endl;\n"
-                  "\n"
-                  "\t\tstd::string line; getline(std::cin >> std::ws, line);\n"
-                  "\t\tUtils::toLowercase(line);\n"
-                  "\n"
-                  "\t\tstd::istringstream line_(line);\n"
-                  "\n"
-                  "\t\tstd::string temp;\n"
-                  "\t\twhile (line_ >> temp){\n"
-                  "\t\t\ttry {\n"
-                  "\t\t\t\tnumber = stod(temp);\n"
-                  "\t\t\t}\n"
-                  "\t\t\tcatch(...) {\n"
-                  "\t\t\t\tcontinue;\n"
-                  "\t\t\t}\n"
-                  "\n"
-                  "\t\t\tvalid = true;\n"
-                  "\t\t\tbreak;\n"
+               << "static constexpr std::string_view GUIDED_MENU =\n"
+                  "\t\"How can I be of assistance?\\n\\n\"\n";
+
+        for (const std::string &chunk : menu)
+            source << chunk;
+
+        source << ";\n"
+               << '\n'
+               << "static constexpr std::string_view GUIDED_MENU_PLAIN =\n"
+                  "\t\"How can I be of assistance?\\n\\n\"\n";
+
+        for (const std::string &chunk : plainMenu)
+            source << chunk;
+
+        source << ";\n";
+
+        source << '\n'
+               << "/**\n"
+                  " * @brief Executes the guided mode of the UI.\n"
+                  " */\n"
+               << "void " << info.classname << "::guidedMode() {\n"
+                  "\tstd::string_view instruction = colorsEnabled() ? GUIDED_MENU : GUIDED_MENU_PLAIN;\n"
+                  "\n";
+
+        source << "\tfor (;;) {\n"
+                  "\t\tint num = (int) -readNumber(instruction);\n"
+                  "\t\tif (!executeCommand(num)) {\n"
+                  "\t\t\t" << backend.out << " << BREAK;\n"
+                  "\t\t\t" << backend.out << " << RED << \"Invalid command! Please, type another command.\" << RESET << " << backend.endl << ";\n"
+                  "\t\t\tcontinue;\n"
                   "\t\t}\n"
                   "\n"
-                  "\t\tif (valid) break;\n"
-                  "\n"
-                  "\t\tstd::cout << BREAK;\n"
-                  "\t\tstd::cout << RED << \"Invalid input! Please, try again.\" << RESET << std::endl;\n"
+                  "\t\t// ask the user if they want to execute another command\n"
+                  "\t\tif (!" << info.classname << "::readYesOrNo(\"Anything else?\"))\n"
+                  "\t\t\tbreak;\n"
                   "\t}\n"
-                  "\n"
-                  "\treturn number;\n"
                   "}\n";
 
-        // readNumber(minimum, maximum)
+        // run()
         source << '\n'
                << "/**\n"
-                  "* @brief Reads a number from the console.\n"
-                  "* @param instruction the instruction that will be displayed before prompting the user to input the number\n"
-                  "* @param minimum the minimum accepted number\n"
-                  "* @param maximum the maximum accepted number\n"
-                  "* @return the number input by the user\n"
-                  "*/\n"
-               << "double " << info.classname << "::readNumber(const std::string &instruction, double minimum, double maximum) {\n"
-                  "\tdouble number;\n"
-                  "\n"
-                  "\tfor(;;) {\n"
-                  "\t\tnumber = " << info.classname << "::readNumber(instruction);\n"
-                  "\n"
-                  "\t\t// verify if the number is within the specified range\n"
-                  "\t\tif (number >= minimum && number <= maximum) {\n"
-                  "\t\t\tbreak;\n"
-                  "\t\t}\n"
+                  " * @brief Runs the command-line menu.\n"
+                  " */\n"
+               << "void " << info.classname << "::run() {\n"
+               << "\tstd::string instruction = \"Which mode would you prefer?\\n\\n\"\n"
+                  "                            " << info.color << " \"* \" RESET \"Guided\\n\"\n"
+                  "                            " << info.color << " \"* \" RESET \"Advanced\";\n"
                   "\n"
-                  "\t\tstd::cout << BREAK;\n"
-                  "\t\tstd::cout << RED << \"Invalid number! Please, try again.\" << RESET << std::endl;\n"
-                  "\t}\n"
+                  "\t(readInput(instruction, {\"guided\", \"advanced\", \"adv\"}) == \"guided\")\n"
+                  "\t\t? " << info.classname << "::guidedMode()\n"
+                  "\t\t: " << info.classname << "::advancedMode();\n"
                   "\n"
-                  "\treturn number;\n"
+                  "\t" << backend.out << " << BREAK;\n"
+                  "\t" << backend.out << " << \"See you next time!\\n\" << " << backend.endl << ";\n"
                   "}\n";
 
-        // readNumber(options)
+        // runScript()
         source << '\n'
                << "/**\n"
-                  " * @brief Reads a number from the console.\n"
-                  " * @param instruction the instruction that will be displayed before prompting the user to input the number\n"
-                  " * @param options the options (numbers) that will be displayed to the user\n"
-                  " * @return the number input by the user\n"
+                  " * @brief Executes the commands of a script, one per line, without any user interaction. Invalid lines\n"
+                  " * are reported and skipped, and a summary is printed at the end.\n"
+                  " * @param path the path to the script, or nullptr to read the script from the standard input\n"
+                  " * @param timings boolean indicating if the execution time of each command should be reported\n"
+                  " * @return the exit status of the program, which signals failure if any line is invalid\n"
                   " */\n"
-               << "double " << info.classname << "::readNumber(const std::string &instruction, const std::vector<double> &options) {\n"
-                  "\tdouble number;\n"
+               << "int " << info.classname << "::runScript(const char *path, bool timings) {\n"
+                  "\tHelpyRuntime::Script script(path);\n"
                   "\n"
-                  "\t// hash the options to achieve better search performance\n"
-                  "\tuSet<double> options_(options.begin(), options.end());\n"
+                  "\tif (!script.isOpen()) {\n"
+                  "\t\t" << backend.err << " << \"Could not open the script '\" << path << \"'!\" << " << backend.endl << ";\n"
+                  "\t\treturn EXIT_FAILURE;\n"
+                  "\t}\n"
                   "\n"
-                  "\tfor (;;) {\n"
-                  "\t\tnumber = " << info.classname << "::readNumber(instruction);\n"
+                  "\tHelpyRuntime::ScriptReport report(COMMAND_NAMES, " << info.commands.size() << ", timings);\n"
                   "\n"
-                  "\t\t// verify if the number is one of the options\n"
-                  "\t\tif (options_.find(number) != options_.end())\n"
-                  "\t\t\tbreak;\n"
+                  "\tstd::string_view line, words[" << info.numArguments + 1 << "];\n"
+                  "\tstd::string lowercase; // the line in lowercase, whose buffer is reused to avoid allocations\n"
+                  "\n"
+                  "\tfor (size_t number = 1; script.nextLine(line); ++number) {\n"
+                  "\t\tlowercase.assign(line); Utils::toLowercase(lowercase);\n"
+                  "\n"
+                  "\t\tsize_t numWords = HelpyRuntime::Script::split(lowercase, words, " << info.numArguments + 1 << ");\n"
+                  "\t\tif (!numWords) continue; // blank line or comment\n"
+                  "\n"
+                  "\t\t// unknown words are worth 0, so they never add up to the value of a command\n"
+                  "\t\tlong long value = 0;\n"
+                  "\n"
+                  "\t\tif (numWords == " << info.numArguments << ") {";
+
+        source << '\n';
+
+        for (int i = 0; i < info.numArguments; ++i)
+            source << "\t\t\tif (auto it = map" << i + 1 << ".find(words[" << i << "]); it != map" << i + 1 << ".end()) value += it->second;\n";
+
+        source << "\t\t}\n"
+                  "\n"
+                  "\t\treport.start();\n"
                   "\n"
-                  "\t\tstd::cout << BREAK;\n"
-                  "\t\tstd::cout << RED << \"Invalid number! Please, try again.\" << RESET << std::endl;\n"
+                  "\t\t(executeCommand(value))\n"
+                  "\t\t\t? report.finish(usageRecorder.last())\n"
+                  "\t\t\t: report.fail(number, line, suggestCommand(words, numWords));\n"
                   "\t}\n"
                   "\n"
-                  "\treturn number;\n"
+                  "\treport.print();\n"
+                  "\treturn report.failures() ? EXIT_FAILURE : EXIT_SUCCESS;\n"
                   "}\n";
 
-        // readFilename()
+        // executeLine()
         source << '\n'
                << "/**\n"
-                  " * @brief Reads a path from the console and verifies if it corresponds to a file.\n"
-                  " * @param instruction the instruction that will be displayed before prompting the user to input the number\n"
-                  " * @return the path input by the user\n"
+                  " * @brief Executes a line sent by a client of the server, with the same tables as the other modes. Lines\n"
+                  " * sent by different clients are executed concurrently, so the commands must be thread-safe unless the\n"
+                  " * server has a single worker.\n"
+                  " * @param line the line\n"
+                  " * @return 'true' if the line is a command, 'false' otherwise\n"
                   " */\n"
-               << "std::string " << info.classname << "::readFilename(const std::string &instruction) {\n"
-                  "\tstd::string filename;\n"
-                  "\tbool valid = false;\n"
-                  "\n"
-                  "\tfor (;;) {\n"
-                  "\t\tstd::string line = " << info.classname << "::readInput(instruction, true);\n"
-                  "\t\tstd::istringstream line_(line);\n"
-                  "\n"
-                  "\t\twhile (!line_.eof()) {\n"
-                  "\t\t\t// fetch the filename\n"
-                  "\t\t\tif (line_.peek() == '\"') {\n"
-                  "\t\t\t\tline_.get(); // consume the leading quotation mark\n"
-                  "\t\t\t\tstd::getline(line_, filename, '\"');\n"
-                  "\t\t\t}\n"
-                  "\t\t\telse {\n"
-                  "\t\t\t\tline_ >> filename;\n"
-                  "\t\t\t}\n"
-                  "\n"
-                  "\t\t\t// verify if the file exists\n"
-                  "\t\t\tif (!std::filesystem::is_regular_file(filename)) {\n"
-                  "\t\t\t\tcontinue;\n"
-                  "\t\t\t}\n"
+               << "bool " << info.classname << "::executeLine(std::string_view line) {\n"
+                  "\tstd::string lowercase(line); Utils::toLowercase(lowercase);\n"
                   "\n"
-                  "\t\t\tvalid = true;\n"
-                  "\t\t\tbreak;\n"
-                  "\t\t}\n"
+                  "\tstd::string_view words[" << info.numArguments + 1 << "];\n"
+                  "\tsize_t numWords = HelpyRuntime::Script::split(lowercase, words, " << info.numArguments + 1 << ");\n"
                   "\n"
-                  "\t\tif (valid) break;\n"
+                  "\t// unknown words are worth 0, so they never add up to the value of a command\n"
+                  "\tlong long value = 0;\n"
                   "\n"
-                  "\t\tstd::cout << BREAK;\n"
-                  "\t\tstd::cout << RED << \"Invalid filename! Please, try again.\" << RESET << std::endl;\n"
-                  "\t}\n"
+                  "\tif (numWords == " << info.numArguments << ") {\n";
+
+        for (int i = 0; i < info.numArguments; ++i)
+            source << "\t\tif (auto it = map" << i + 1 << ".find(words[" << i << "]); it != map" << i + 1 << ".end()) value += it->second;\n";
+
+        source << "\t}\n"
                   "\n"
-                  "\treturn filename;\n"
+                  "\treturn executeCommand(value);\n"
                   "}\n";
 
-        // readDirname()
+        // run(argc, argv)
         source << '\n'
                << "/**\n"
-                  " * @brief Reads a path from the console and verifies if it corresponds to a directory.\n"
-                  " * @param instruction the instruction that will be displayed before prompting the user to input the number\n"
-                  " * @return the path input by the user\n"
+                  " * @brief Runs the program according to the command-line arguments, which may be:\n"
+                  " * - a command, which is executed without any user interaction;\n"
+                  " * - '--script <file>', which executes the commands of a script (see runScript());\n"
+                  " * - nothing, in which case the command-line menu is run or, if the standard input is not a terminal,\n"
+                  " * the commands are read from it as a script.\n"
+                  " * The option '--timings' reports the execution time of the commands of a script, and the option\n"
+                  " * '--trace <file>' saves a trace of the execution to a file, in the Chrome trace-event format.\n"
+                  " * The option '--serve <socket>' serves clients over a Unix domain socket instead (see executeLine()),\n"
+                  " * with as many workers as the option '--workers <n>' specifies (by default, one per hardware thread).\n"
+                  " * The option '--record <file>' runs the command-line menu and saves the transcript of the session, and\n"
+                  " * the option '--replay <path>' replays the transcripts in a file or directory in parallel, with the same\n"
+                  " * workers, and verifies if their output is unchanged (see HelpyRuntime::Replayer).\n"
+                  " * @param argc the number of command-line arguments\n"
+                  " * @param argv the command-line arguments, the first of which is the name of the program\n"
+                  " * @return the exit status of the program\n"
                   " */\n"
-               << "std::string " << info.classname << "::readDirname(const std::string &instruction) {\n"
-                  "\tstd::string dirname;\n"
-                  "\tbool valid = false;\n"
-                  "\n"
-                  "\tfor (;;) {\n"
-                  "\t\tstd::string line = " << info.classname << "::readInput(instruction, true);\n"
-                  "\t\tstd::istringstream line_(line);\n"
-                  "\n"
-                  "\t\twhile (!line_.eof()) {\n"
-                  "\t\t\t// fetch the name of the directory\n"
-                  "\t\t\tif (line_.peek() == '\"') {\n"
-                  "\t\t\t\tline_.get(); // consume the leading quotation mark\n"
-                  "\t\t\t\tstd::getline(line_, dirname, '\"');\n"
-                  "\t\t\t}\n"
-                  "\t\t\telse {\n"
-                  "\t\t\t\tline_ >> dirname;\n"
-                  "\t\t\t}\n"
-                  "\n"
-                  "\t\t\t// verify if the file exists\n"
-                  "\t\t\tif (!std::filesystem::is_directory(dirname)) {\n"
-                  "\t\t\t\tcontinue;\n"
-                  "\t\t\t}\n"
+               << "int " << info.classname << "::run(int argc, char **argv) {\n"
+                  "\tconst char *script = nullptr, *trace = nullptr, *server = nullptr, *record = nullptr, *replay = nullptr;\n"
+                  "\tunsigned workers = 0;\n"
+                  "\tbool timings = false;\n"
+                  "\n"
+                  "\t// parse the options\n"
+                  "\tint first = 1;\n"
                   "\n"
-                  "\t\t\tvalid = true;\n"
+                  "\tfor (; first < argc; ++first) {\n"
+                  "\t\tstd::string_view option = argv[first];\n"
+                  "\n"
+                  "\t\tif (option == \"--script\" && first + 1 < argc)\n"
+                  "\t\t\tscript = argv[++first];\n"
+                  "\t\telse if (option == \"--timings\")\n"
+                  "\t\t\ttimings = true;\n"
+                  "\t\telse if (option == \"--trace\" && first + 1 < argc)\n"
+                  "\t\t\ttrace = argv[++first];\n"
+                  "\t\telse if (option == \"--serve\" && first + 1 < argc)\n"
+                  "\t\t\tserver = argv[++first];\n"
+                  "\t\telse if (option == \"--workers\" && first + 1 < argc)\n"
+                  "\t\t\tworkers = (unsigned) strtoul(argv[++first], nullptr, 10);\n"
+                  "\t\telse if (option == \"--record\" && first + 1 < argc)\n"
+                  "\t\t\trecord = argv[++first];\n"
+                  "\t\telse if (option == \"--replay\" && first + 1 < argc)\n"
+                  "\t\t\treplay = argv[++first];\n"
+                  "\t\telse\n"
                   "\t\t\tbreak;\n"
-                  "\t\t}\n"
+                  "\t}\n"
                   "\n"
-                  "\t\tif (valid) break;\n"
+                  "\t// the trace is saved when the recorder is destroyed, however the program ends\n"
+                  "\tHelpyRuntime::TraceRecorder traceRecorder(trace);\n"
                   "\n"
-                  "\t\tstd::cout << BREAK;\n"
-                  "\t\tstd::cout << RED << \"Invalid directory! Please, try again.\" << RESET << std::endl;\n"
+                  "\tif (server) {\n"
+               << (options.stats ? "\t\tlatencyStats.share(true);\n" : "")
+               << "\t\treturn serve(server, workers, [this](std::string_view line) { return executeLine(line); });\n"
                   "\t}\n"
                   "\n"
-                  "\t// format the name of the directory\n"
-                  "\tif (dirname.back() != '/') {\n"
-                  "\t\tdirname += '/';\n"
+                  "\tif (record || replay) {\n"
+                  "\t\t// each session runs in an instance of its own\n"
+                  "\t\tauto session = [] { " << info.classname << " helpy; helpy.run(); };\n"
+                  "\t\treturn record ? recordSession(record, session) : replaySessions(replay, workers, session);\n"
                   "\t}\n"
                   "\n"
-                  "\treturn dirname;\n"
-                  "}\n";
+                  "\tint numWords = argc - first;\n"
+                  "\n"
+                  "\tif (script || (!numWords && !interactive()))\n"
+                  "\t\treturn runScript(script, timings);\n"
+                  "\n"
+                  "\tif (!numWords) {\n"
+                  "\t\trun();\n"
+                  "\t\treturn EXIT_SUCCESS;\n"
+                  "\t}\n"
+                  "\n"
+                  "\t// unknown words are worth 0, so they never add up to the value of a command\n"
+                  "\tlong long value = 0;\n"
+                  "\n"
+                  "\tstd::string_view words[" << info.numArguments << "];\n"
+                  "\n"
+                  "\tif (numWords == " << info.numArguments << ") {\n"
+                  "\t\t// the words are turned into lowercase in place\n"
+                  "\t\tfor (int i = 0; i < " << info.numArguments << "; ++i) {\n"
+                  "\t\t\twords[i] = argv[first + i];\n"
+                  "\t\t\tUtils::toLowercase(argv[first + i], words[i].size());\n"
+                  "\t\t}\n"
+                  "\n";
 
-        // readCSV()
-        source << '\n'
-               << "/**\n"
-                  " * @brief Reads and parses a line of user input containing comma-separated values.\n"
-                  " * @param instruction the instruction that will be displayed before prompting the user to input\n"
-                  " * @param delimiter the character that separates each value\n"
-                  " * @return the values input by the user\n"
-                  " */\n"
-               << "std::vector<std::string> " << info.classname << "::readCSV(const std::string &instruction, char delimiter) {\n"
-                  "\tstd::cout << BREAK;\n"
-                  "\tstd::cout << instruction << '\\n' << std::endl;\n"
+        for (int i = 0; i < info.numArguments; ++i)
+            source << "\t\tif (auto it = map" << i + 1 << ".find(words[" << i << "]); it != map" << i + 1 << ".end()) value += it->second;\n";
+
+        source << "\t}\n"
                   "\n"
-                  "\t// read the user input\n"
-                  "\tstd::string line; getline(std::cin >> std::ws, line);\n"
-                  "\tUtils::toLowercase(line);\n"
+                  "\tif (!executeCommand(value)) {\n"
+                  "\t\t" << backend.err << " << \"Invalid command!\" << " << backend.endl << ";\n"
                   "\n"
-                  "\tstd::istringstream line_(line);\n"
+                  "\t\tif (numWords == " << info.numArguments << ") {\n"
+                  "\t\t\tif (std::string_view suggestion = suggestCommand(words, numWords); !suggestion.empty())\n"
+                  "\t\t\t\t" << backend.err << " << suggestion << " << backend.endl << ";\n"
+                  "\t\t}\n"
                   "\n"
-                  "\t// separate the user input into values\n"
-                  "\tstd::vector<std::string> values;\n"
-                  "\tfor (std::string value; getline(line_, value, delimiter); ) {\n"
-                  "\t\tvalues.emplace_back(value);\n"
+                  "\t\treturn EXIT_FAILURE;\n"
                   "\t}\n"
                   "\n"
-                  "\treturn values;\n"
+                  "\treturn EXIT_SUCCESS;\n"
                   "}\n";
+    }
 
-        // executeCommand()
-        source << "\n"
-                  "/**\n"
-                  " * @brief Parses the arguments that were input and executes the corresponding command.\n"
-                  " * @param value the value that will be used in the switch case to choose which command to execute\n"
-                  " * @return 'true' if the command exists, 'false' otherwise\n"
-                  " */\n"
-               << "bool " << info.classname << "::executeCommand(int value) {\n"
-                  "\tswitch (value) {\n";
+    void Writer::writeHeader() {
+        writeHeaderGuards();
+        writeIncludes();
+        if (options.plugins) writePluginDeclarations();
+        writeClass();
 
-        for (int i = 0; i < (int) info.commands.size(); ++i)
-            source << "\t\tcase -" << i + 1 << " :\n"
-                      "\t\tcase " << info.commands[i].getValue() << " :\n"
-                      "\t\t\t" << info.commands[i].getSignature() << "();\n"
-                      "\t\t\t" << "break;\n\n";
+        // close the header guard
+        header << '\n'
+               << "#endif\n";
+    }
 
-        source << "\t\tdefault :\n"
-               << "\t\t\tstd::cout << BREAK;\n"
-               << "\t\t\tstd::cout << RED << \"Invalid command! Please, type another command.\" << RESET << std::endl;\n"
-               << '\n'
-               << "\t\t\treturn false;\n"
-               << "\t}\n"
-               << '\n'
-               << "\treturn true;\n"
-               << "}\n";
+    void Writer::writeSource() {
+        source << "#include \"" << info.filename << ".h\"\n";
+        writeMacros(source);
 
-        // advancedMode()
+        // keyword maps
+        source << '\n';
+
+        for (const std::string &keywordMap : keywordMaps)
+            source << keywordMap;
+
+        // command names
         source << '\n'
                << "/**\n"
-                  " * @brief Executes the advanced mode of the UI.\n"
+                  " * @brief The names of the commands, which identify them in usage profiles.\n"
                   " */\n"
-               << "void " << info.classname << "::advancedMode() {\n"
-                  "\tfor (;;) {\n"
-                  "\t\tstd::cout << BREAK;\n"
-                  "\t\tstd::cout << \"How can I be of assistance?\" << '\\n' << std::endl;\n"
-                  "\n"
-                  "\t\tstd::string ";
+               << "static constexpr std::string_view COMMAND_NAMES[] = {\n";
 
-        for (int i = 1; i <= info.numArguments; ++i)
-            source << 's' << i << ((i < info.numArguments) ? ", " : ";\n");
+        for (const std::string &chunk : commandNames)
+            source << chunk;
 
-        source << "\t\tstd::istringstream s_;\n"
-                  "\n"
-                  "\t\tstd::cin >> s1; Utils::toLowercase(s1);\n"
-                  "\n"
-                  "\t\tif (s1 == \"quit\" || s1 == \"no\" || s1 == \"die\")\n"
-                  "\t\t\tbreak;\n"
-                  "\n";
+        source << "};\n";
 
-        for (int i = 2; i <= info.numArguments; ++i)
-            source << "\t\tstd::cin >> s" << i << "; Utils::toLowercase(s" << i << ");\n";
+        source << commandTrie;
 
-        source << "\n"
-                  "\t\tif (!executeCommand(";
+        if (options.plugins)
+            writePluginSymbols(source);
 
-        for (int i = 1; i <= info.numArguments; ++i)
-            source << "map" << i << "[s" << i << ']' << ((i < info.numArguments) ? " + " : "))\n");
+        // user-defined methods (unless they were sharded)
+        for (const std::string &chunk : userMethods)
+            source << chunk;
 
-        source << "\t\t\tcontinue;\n"
-                  "\n"
-                  "\t\t// ask the user if they want to execute another command\n"
-                  "\t\tif (!" << info.classname << "::readYesOrNo(\"Anything else?\"))\n"
-                  "\t\t\tbreak;\n"
-                  "\t}\n"
-                  "}\n";
+        writeHelpyMethods();
+    }
 
-        // guidedMode()
-        source << '\n'
-               << "/**\n"
-                  " * @brief Executes the guided mode of the UI.\n"
-                  " */\n"
-               << "void " << info.classname << "::guidedMode() {\n"
-                  "\tstd::string instruction = \"How can I be of assistance?\\n\\n\";\n"
-                  "\n";
+    void Writer::writeSourcesList(std::ostream &out) {
+        std::string uppercaseFilename;
 
-        int numCommands = (int) info.commands.size();
+        for (char c : info.filename)
+            uppercaseFilename += (char) toupper(c);
 
-        for (int i = 1; i <= numCommands; ++i) {
-            const Command &command = info.commands[i - 1];
+        out << "# The source files of " << info.classname << ", to be included by CMake projects.\n"
+            << "set(" << uppercaseFilename << "_SOURCES\n"
+            << "        ${CMAKE_CURRENT_LIST_DIR}/" << info.filename << ".cpp";
 
-            source << "\t// " << command.getSignature() << "()\n"
-                   << "\tinstruction += (std::string) BOLD + " << info.color << " + \"" << i << " - \" + WHITE + \"";
+        if (!options.plugins) {
+            for (const auto &[filename, shard] : shards)
+                out << "\n        ${CMAKE_CURRENT_LIST_DIR}/" << filename;
+        }
 
-            bool hasDescription = !command.getDescription().empty(); // verify if the command has a description
-            bool isLast = i == numCommands; // verify if we are writing the last command
+        out << ")\n";
+
+        if (options.plugins) {
+            out << "\n"
+                   "# the source files of the plugins, each of which holds some of the commands\n"
+                   "set(" << uppercaseFilename << "_PLUGINS";
+
+            for (const auto &[filename, shard] : shards)
+                out << "\n        ${CMAKE_CURRENT_LIST_DIR}/" << filename;
+
+            out << ")\n"
+                   "\n"
+                   "# builds the plugins next to a target, which exports the runtime to them, e.g.\n"
+                   "# " << info.filename << "_add_plugins(<target>)\n"
+                   "function(" << info.filename << "_add_plugins target)\n"
+                   "    set_target_properties(${target} PROPERTIES ENABLE_EXPORTS ON)\n"
+                   "    target_link_options(${target} PRIVATE\n"
+                   "            LINKER:--whole-archive $<TARGET_FILE:helpy_runtime> LINKER:--no-whole-archive)\n"
+                   "    get_target_property(standard ${target} CXX_STANDARD)\n"
+                   "\n"
+                   "    foreach (source ${" << uppercaseFilename << "_PLUGINS})\n"
+                   "        get_filename_component(plugin ${source} NAME_WE)\n"
+                   "\n"
+                   "        add_library(${plugin} MODULE ${source})\n"
+                   "        target_include_directories(${plugin} PRIVATE\n"
+                   "                $<TARGET_PROPERTY:helpy_runtime,INTERFACE_INCLUDE_DIRECTORIES>)\n"
+                   "        set_target_properties(${plugin} PROPERTIES\n"
+                   "                PREFIX \"\"\n"
+                   "                SUFFIX \".so\"\n"
+                   "                CXX_VISIBILITY_PRESET hidden\n"
+                   "                LIBRARY_OUTPUT_DIRECTORY $<TARGET_FILE_DIR:${target}>)\n"
+                   "\n"
+                   "        if (standard)\n"
+                   "            set_target_properties(${plugin} PROPERTIES CXX_STANDARD ${standard})\n"
+                   "        endif ()\n"
+                   "\n"
+                   "        add_dependencies(${target} ${plugin})\n"
+                   "    endforeach ()\n"
+                   "endfunction()\n";
+        }
 
-            switch ((isLast << 1) + hasDescription) {
-                // write command that neither has a description nor is last
-                case 0 :
-                    source << command.getName() << "\\n\"\n"
-                           << "\t            + RESET + '\\n'";
-                    break;
+        if (coroutines) {
+            out << "\n"
+                   "# the commands marked as COROUTINE require C++20, e.g.\n"
+                   "# set_target_properties(<target> PROPERTIES CXX_STANDARD ${" << uppercaseFilename << "_CXX_STANDARD})\n"
+                   "set(" << uppercaseFilename << "_CXX_STANDARD 20)\n";
+        }
+    }
 
-                // write command that has a description but is not last
-                case 1 :
-                    source << command.getName() << "\\n\"\n"
-                           << "\t            + RESET + ITALICS + \"" << command.getDescription() << "\\n\"\n"
-                           << "\t            + RESET + '\\n'";
-                    break;
+    /**
+     * @brief Writes the generated code to the output directory.
+     *
+     * Files whose contents did not change are left untouched, so build systems only recompile what is
+     * actually different. Shards and plugins that are no longer generated are removed.
+     */
+    void Writer::writeFiles() {
+        Utils::writeFile(path + info.filename + ".h", header.str());
+        Utils::writeFile(path + info.filename + ".cpp", source.str());
+
+        std::ostringstream sourcesList;
+        writeSourcesList(sourcesList);
+        Utils::writeFile(path + info.filename + "_sources.cmake", sourcesList.str());
+
+        uSet<std::string> filenames;
+
+        for (const auto &[filename, shard] : shards) {
+            Utils::writeFile(path + filename, shard);
+            filenames.insert(filename);
+        }
 
-                // write the last command (without description)
-                case 2 :
-                    source << command.getName() << "\"\n"
-                           << "\t            + RESET";
-                    break;
+        // remove the stale shards and plugins
+        std::string shardPrefix = info.filename + "_shard_", pluginPrefix = info.filename + "_plugin_";
 
-                // write the last command (with description)
-                case 3 :
-                    source << command.getName() << "\\n\"\n"
-                           << "\t            + RESET + ITALICS + \"" << command.getDescription() << "\"\n"
-                           << "\t            + RESET";
-                    break;
-            }
+        for (const auto &entry : std::filesystem::directory_iterator(path.empty() ? "." : path)) {
+            std::string filename = entry.path().filename().string();
+
+            bool generated = !filename.compare(0, shardPrefix.size(), shardPrefix)
+                || !filename.compare(0, pluginPrefix.size(), pluginPrefix);
 
-            source << ";\n"
-                   << '\n';
+            if (generated && filenames.find(filename) == filenames.end())
+                std::filesystem::remove(entry.path());
         }
+    }
 
-        source << "\tfor (;;) {\n"
-                  "\t\tint num = (int) -readNumber(instruction);\n"
-                  "\t\tif (!executeCommand(num))\n"
-                  "\t\t\tcontinue;\n"
-                  "\n"
-                  "\t\t// ask the user if they want to execute another command\n"
-                  "\t\tif (!" << info.classname << "::readYesOrNo(\"Anything else?\"))\n"
-                  "\t\t\tbreak;\n"
-                  "\t}\n"
-                  "}\n";
+    /**
+     * @brief Writes the code of the Helpy class.
+     *
+     * The parts of the code whose size grows with the number of commands are split into chunks, which are
+     * written concurrently by the thread pool and then merged in order. The commands are not modified while
+     * the chunks are being written.
+     */
+    void Writer::execute() {
+        assignValues();
+        if (options.shardSize || options.plugins) partitionShards();
 
-        // run()
-        source << '\n'
-               << "/**\n"
-                  " * @brief Runs the command-line menu.\n"
-                  " */\n"
-               << "void " << info.classname << "::run() {\n"
-               << "\tstd::string instruction = \"Which mode would you prefer?\\n\\n\"\n"
-                  "                            " << info.color << " \"* \" RESET \"Guided\\n\"\n"
-                  "                            " << info.color << " \"* \" RESET \"Advanced\";\n"
-                  "\n"
-                  "\t(readInput(instruction, {\"guided\", \"advanced\", \"adv\"}) == \"guided\")\n"
-                  "\t\t? " << info.classname << "::guidedMode()\n"
-                  "\t\t: " << info.classname << "::advancedMode();\n"
-                  "\n"
-                  "\tstd::cout << BREAK;\n"
-                  "\tstd::cout << \"See you next time!\\n\" << std::endl;\n"
-                  "}\n";
-    }
+        size_t numCommands = info.commands.size();
 
-    void Writer::writeUtils() {
-        utils << "\n"
-                 "namespace Utils {\n";
-
-        // toLowercase()
-        utils << "\t/**\n"
-                 "\t * @brief Turns all the characters of a string into lowercase.\n"
-                 "\t * @complexity O(n)\n"
-                 "\t * @param s string to be modified\n"
-                 "\t */\n"
-              << "\tstatic void toLowercase(std::string &s) {\n"
-                 "\t\tfor (char &c : s)\n"
-                 "\t\t\tc = (char) tolower(c);\n"
-                 "\t}\n";
-
-        // toUppercase()
-        utils << "\n"
-                 "\t/**\n"
-                 "\t * @brief Turns all the characters of a string into uppercase.\n"
-                 "\t * @complexity O(n)\n"
-                 "\t * @param s string to be modified\n"
-                 "\t */\n"
-              << "\tstatic void toUppercase(std::string &s) {\n"
-                 "\t\tfor (char &c : s)\n"
-                 "\t\t\tc = (char) toupper(c);\n"
-                 "\t}\n";
-
-        // createTable()
-        utils << "\n"
-                 "\t/**\n"
-                 "\t* @brief Creates a fort::char_table that will be used to display information in the terminal.\n"
-                 "\t* @param columnNames list containing the name of each column of the table\n"
-                 "\t* @return fort::char_table object\n"
-                 "\t*/\n"
-              << "\tstatic fort::char_table createTable(const std::vector<std::string> &columnNames) {\n"
-                 "\t\tfort::char_table table;\n"
-                 "\n"
-                 "\t\t// customize the table\n"
-                 "\t\ttable.set_border_style(FT_NICE_STYLE);\n"
-                 "\t\ttable.row(0).set_cell_content_text_style(fort::text_style::bold);\n"
-                 "\t\ttable.row(0).set_cell_content_fg_color(fort::color::yellow);\n"
-                 "\n"
-                 "\t\t// set the table header\n"
-                 "\t\ttable << fort::header;\n"
-                 "\t\tauto it = columnNames.begin();\n"
-                 "\n"
-                 "\t\tfor (int i = 0; it != columnNames.end(); ++i) {\n"
-                 "\t\t\ttable << *it++;\n"
-                 "\n"
-                 "\t\t\t// set the alignment of each column\n"
-                 "\t\t\ttable.column(i).set_cell_text_align(fort::text_align::center);\n"
-                 "\t\t}\n"
-                 "\n"
-                 "\t\ttable << fort::endr;\n"
-                 "\t\treturn table;\n"
-                 "\t}\n";
-
-        // createUTF8Table()
-        utils << "\n"
-                 "\t/**\n"
-                 "\t* @brief Creates a fort::utf8_table that will be used to display information in the terminal.\n"
-                 "\t* @param columnNames list containing the name of each column of the table\n"
-                 "\t* @return fort::utf8_table object\n"
-                 "\t*/\n"
-              << "\tstatic fort::utf8_table createUTF8Table(const std::vector<std::string> &columnNames) {\n"
-                 "\t\tfort::utf8_table table;\n"
-                 "\n"
-                 "\t\t// customize the table\n"
-                 "\t\ttable.set_border_style(FT_NICE_STYLE);\n"
-                 "\t\ttable.row(0).set_cell_content_text_style(fort::text_style::bold);\n"
-                 "\t\ttable.row(0).set_cell_content_fg_color(fort::color::yellow);\n"
-                 "\n"
-                 "\t\t// set the table header\n"
-                 "\t\ttable << fort::header;\n"
-                 "\t\tauto it = columnNames.begin();\n"
-                 "\n"
-                 "\t\tfor (int i = 0; it != columnNames.end(); ++i) {\n"
-                 "\t\t\ttable << *it++;\n"
-                 "\n"
-                 "\t\t\t// set the alignment of each column\n"
-                 "\t\t\ttable.column(i).set_cell_text_align(fort::text_align::center);\n"
-                 "\t\t}\n"
-                 "\n"
-                 "\t\ttable << fort::endr;\n"
-                 "\t\treturn table;\n"
-                 "\t}\n";
-
-        // createMDTable()
-        utils << "\n"
-                 "\t/**\n"
-                 "\t * @brief Creates a table that will be output to a Markdown file.\n"
-                 "\t * @param columnNames list containing the name of each column of the table\n"
-                 "\t * @return string representing a Markdown table\n"
-                 "\t */\n"
-              << "\tstatic std::string createMDTable(const std::vector<std::string> &columnNames) {\n"
-                 "\t\tsize_t numColumns = columnNames.size();\n"
-                 "\t\tif (numColumns == 0) return \"\";\n"
-                 "\n"
-                 "\t\tstd::string table = \"|\";\n"
-                 "\n"
-                 "\t\t// set the table header\n"
-                 "\t\tfor (const std::string &columnName : columnNames)\n"
-                 "\t\t\ttable += ' ' + columnName + \" |\";\n"
-                 "\n"
-                 "\t\ttable += \"\\n|\";\n"
-                 "\n"
-                 "\t\t// set the alignment of each column\n"
-                 "\t\tfor (size_t i = 0; i < numColumns; ++i)\n"
-                 "\t\t\ttable += \":-:|\";\n"
-                 "\n"
-                 "\t\ttable += '\\n';\n"
-                 "\t\treturn table;\n"
-                 "\t}\n";
-
-        utils << "}\n"
-                 "\n"
-                 "#endif\n";
-    }
+        keywordMaps.resize(info.numArguments);
+        for (int i = 0; i < info.numArguments; ++i) {
+            pool.submit([this, i] {
+                std::ostringstream out;
+                writeKeywordMap(out, i);
+                keywordMaps[i] = out.str();
+            });
+        }
 
-    void Writer::writeHeader() {
-        writeClass();
+        writeChunks(declarations, numCommands, [this](std::ostream &out, size_t begin, size_t end) {
+            writeMethodsDeclaration(out, begin, end);
+        });
+
+        writeChunks(commandNames, numCommands, [this](std::ostream &out, size_t begin, size_t end) {
+            writeCommandNames(out, begin, end);
+        });
+
+        pool.submit([this] {
+            std::ostringstream out;
+            writeCommandTrie(out);
+            commandTrie = out.str();
+        });
+
+        if (options.shardSize || options.plugins) {
+            for (size_t i = 0; i < shards.size(); ++i) {
+                pool.submit([this, i] {
+                    std::ostringstream out;
+                    writeShard(out, i);
+                    shards[i].second = out.str();
+                });
+            }
+        }
+        else {
+            writeChunks(userMethods, numCommands, [this](std::ostream &out, size_t begin, size_t end) {
+                writeUserMethods(out, begin, end);
+            });
+        }
 
-        // close the header guard
-        header << '\n'
-               << "#endif\n";
-    }
+        writeChunks(menu, numCommands, [this](std::ostream &out, size_t begin, size_t end) {
+            writeGuidedMenu(out, begin, end, false);
+        });
 
-    void Writer::writeSource() {
-        writeMacros();
-        writeKeywordMaps();
-        writeUserMethods();
-        writeHelpyMethods();
-    }
+        writeChunks(plainMenu, numCommands, [this](std::ostream &out, size_t begin, size_t end) {
+            writeGuidedMenu(out, begin, end, true);
+        });
 
-    void Writer::execute() {
-        writeHeaderGuards();
-        writeIncludes();
+        writeChunks(dispatch, numCommands, [this](std::ostream &out, size_t begin, size_t end) {
+            writeDispatch(out, begin, end);
+        });
+
+        pool.wait();
 
-        // write the code
-        std::thread t1(&Writer::writeSource, this);
-        std::thread t2(&Writer::writeUtils, this);
+        // merge the chunks
         writeHeader();
+        writeSource();
 
-        t1.join();
-        t2.join();
+        writeFiles();
     }
 }
@@ -1,44 +1,98 @@
 #ifndef HELPY_WRITER_H
 #define HELPY_WRITER_H
 
-#include <fstream>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 #include <unordered_map>
 
 #include "../parser/parser.h"
 #include "../utils/command.hpp"
+#include "../utils/thread_pool.hpp"
 
 #define uMap std::unordered_map
 
 namespace Helpy {
+    struct WriterOptions {
+        unsigned shardSize = 0; // the average number of commands per shard (0 disables sharding)
+        std::string profile; // path to a usage profile recorded by the generated code (optional)
+        bool hotMenu = false; // whether the guided mode should list the most used commands first
+        bool lite = false; // whether the generated code should use the lightweight (iostream-free) runtime
+        bool stats = false; // whether the generated code should record the latency of each command
+        bool plugins = false; // whether each shard should be built as a plugin, which is loaded when first executed
+    };
+
+    /**
+     * @brief The names the generated code uses to perform I/O, which depend on the backend it is written for.
+     */
+    struct Backend {
+        const char *runtime, *console, *out, *err, *in, *endl;
+    };
+
     class Writer {
+        std::string path;
         ParserInfo info;
-        std::ofstream header, source, utils;
-        std::vector<uMap<std::string, int>> maps;
+        WriterOptions options;
+        const Backend &backend;
+        bool async; // whether any command runs in the background
+        bool coroutines; // whether any command is a coroutine, which requires C++20
+        bool cached; // whether the output of any command is cached
+        std::ostringstream header, source;
+        std::vector<uMap<std::string, long long>> maps;
+        std::vector<std::vector<std::string>> keywords;
+        std::vector<uint64_t> usage;
+        std::vector<int> dispatchOrder, menuOrder, menuNumbers;
+        std::vector<bool> hot;
+
+        // the code that grows with the number of commands, which is written in chunks by the thread pool
+        ThreadPool pool;
+        std::vector<std::string> keywordMaps, declarations, commandNames, userMethods, menu, plainMenu, dispatch;
+        std::string commandTrie;
+        std::vector<std::pair<std::string, std::string>> shards;
+        std::vector<size_t> shardStarts;
 
     /* CONSTRUCTOR */
     public:
-        Writer(const std::string &path, ParserInfo info);
+        Writer(std::string path, ParserInfo info, WriterOptions options = {});
 
     /* METHODS */
     private:
+        void readProfile();
+        void orderCommands();
+        void assignValues();
+        void partitionShards();
+        std::string callCommand(size_t index, const std::string &args);
+
+        template <typename F>
+        void writeChunks(std::vector<std::string> &chunks, size_t size, F write);
+
         void writeHeaderGuards();
         void writeIncludes();
 
         // header
-        void writeMethodsDeclaration();
+        void writeMethodsDeclaration(std::ostream &out, size_t begin, size_t end);
+        void writePluginDeclarations();
         void writeClass();
 
         // source
-        void writeMacros();
-        void writeKeywordMaps();
-        void writeUserMethods();
+        void writeMacros(std::ostream &out);
+        void writeKeywordMap(std::ostream &out, int position);
+        void writeCommandNames(std::ostream &out, size_t begin, size_t end);
+        void writeCommandTrie(std::ostream &out);
+        void writeUserMethod(std::ostream &out, const Command &command);
+        void writeUserMethods(std::ostream &out, size_t begin, size_t end);
+        void writePluginEntry(std::ostream &out, const Command &command);
+        void writePluginSymbols(std::ostream &out);
+        void writeShard(std::ostream &out, size_t index);
+        void writeGuidedMenu(std::ostream &out, size_t begin, size_t end, bool plain);
+        void writeDispatch(std::ostream &out, size_t begin, size_t end);
         void writeHelpyMethods();
 
-        void writeUtils();
         void writeHeader();
         void writeSource();
+        void writeSourcesList(std::ostream &out);
+        void writeFiles();
 
     public:
         void execute();
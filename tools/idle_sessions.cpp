@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "coro/coro.h"
+#include "io/io.h"
+
+namespace IO = HelpyRuntime::IO;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Returns the resident set size of the program.
+ * @return the resident set size, in bytes
+ */
+static size_t residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t size = 0, resident = 0;
+    statm >> size >> resident;
+
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * @brief A command that waits for a number, like the generated commands marked as COROUTINE.
+ * @param input the input of the command
+ * @param sum the variable the number is added to
+ */
+static HelpyRuntime::Task<> command(HelpyRuntime::InputSession &input, long long &sum) {
+    sum += co_await input.readInteger("Enter a number", 0, 100);
+}
+
+/**
+ * @brief Measures the memory taken by sessions that wait for input, which are either coroutines multiplexed on the
+ * calling thread (see SessionLoop) or, for comparison, threads blocked on a condition variable. The sessions are
+ * then given their input, which measures the cost of resuming a session.
+ *
+ * Usage: helpy_idle_sessions [-n <sessions>] [--threads]
+ */
+int main(int argc, char *argv[]) {
+    size_t numSessions = 100000;
+    bool threads = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            numSessions = std::max(1ul, strtoul(argv[++i], nullptr, 10));
+        else if (!strcmp(argv[i], "--threads"))
+            threads = true;
+        else {
+            IO::err << "Usage: " << argv[0] << " [-n <sessions>] [--threads]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    size_t before = residentBytes(), after;
+    long long sum = 0;
+    double nanosecondsPerResume = 0;
+
+    if (threads) {
+        std::mutex mutex;
+        std::condition_variable input;
+        bool ready = false;
+        std::vector<std::thread> sessions;
+
+        for (size_t i = 0; i < numSessions; ++i) {
+            sessions.emplace_back([&] {
+                std::unique_lock<std::mutex> lock(mutex);
+                input.wait(lock, [&ready] { return ready; });
+
+                ++sum;
+            });
+        }
+
+        after = residentBytes();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready = true;
+        }
+
+        input.notify_all();
+
+        for (std::thread &session : sessions)
+            session.join();
+    }
+    else {
+        HelpyRuntime::SessionLoop loop;
+        std::vector<size_t> ids;
+        ids.reserve(numSessions);
+
+        for (size_t i = 0; i < numSessions; ++i)
+            ids.push_back(loop.start([&sum](HelpyRuntime::InputSession &input) { return command(input, sum); }));
+
+        // the prompts are discarded, as a server would send them to the clients
+        for (size_t id : ids)
+            loop.takeOutput(id).clear();
+
+        after = residentBytes();
+
+        // the first input is invalid, so each session is resumed twice
+        auto start = Clock::now();
+
+        for (size_t id : ids) {
+            loop.feed(id, "abc");
+            loop.feed(id, "1");
+        }
+
+        nanosecondsPerResume = std::chrono::duration<double, std::nano>(Clock::now() - start).count()
+            / (2.0 * (double) numSessions);
+
+        if (loop.size()) {
+            IO::err << loop.size() << " sessions did not finish!\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (sum != (long long) numSessions) {
+        IO::err << "The sessions read " << sum << " numbers instead of " << numSessions << "!\n";
+        return EXIT_FAILURE;
+    }
+
+    double bytesPerSession = (double) (after - before) / (double) numSessions;
+
+    IO::out << numSessions << (threads ? " blocked threads" : " suspended coroutines") << " took "
+        << (after - before) / 1024 << " KiB, i.e. " << (size_t) bytesPerSession << " bytes per session ("
+        << (size_t) ((double) (1ull << 30) / bytesPerSession) << " idle sessions per GiB)\n";
+
+    if (!threads)
+        IO::out << "Resuming a session took " << (size_t) nanosecondsPerResume << " ns\n";
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "io/io.h"
+#include "stats/stats.h"
+
+namespace IO = HelpyRuntime::IO;
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief A connection to a Helpy server, which sends a command and waits for its reply.
+ */
+class Connection {
+    int fd;
+    std::string buffer;
+
+/* CONSTRUCTOR */
+public:
+    explicit Connection(const char *path) : fd(socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+        if (fd >= 0 && connect(fd, (sockaddr *) &address, sizeof(address))) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    Connection(const Connection &) = delete;
+
+/* DESTRUCTOR */
+public:
+    ~Connection() {
+        if (fd >= 0) close(fd);
+    }
+
+/* METHODS */
+private:
+    /**
+     * @brief Reads from the socket until the buffer has at least a certain number of bytes.
+     * @param size the number of bytes
+     * @return 'true' if the bytes were read, 'false' if the server disconnected
+     */
+    bool fill(size_t size) {
+        char data[1 << 16];
+
+        while (buffer.size() < size) {
+            ssize_t received = read(fd, data, sizeof(data));
+            if (received <= 0) return false;
+
+            buffer.append(data, received);
+        }
+
+        return true;
+    }
+
+public:
+    [[nodiscard]] bool connected() const {
+        return fd >= 0;
+    }
+
+    /**
+     * @brief Sends a command and reads the reply, discarding its output.
+     * @param line the command, which ends with a newline
+     * @return the status of the reply, or -1 if the server disconnected
+     */
+    int request(std::string_view line) {
+        for (size_t sent = 0; sent < line.size(); ) {
+            ssize_t written = send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) return -1;
+
+            sent += written;
+        }
+
+        // the reply is a sequence of output frames ("O <length>\n<output>") followed by an end frame ("E <status>\n")
+        for (;;) {
+            size_t newline;
+
+            while ((newline = buffer.find('\n')) == std::string::npos) {
+                if (!fill(buffer.size() + 1)) return -1;
+            }
+
+            char type = buffer[0];
+            long long number = strtoll(buffer.c_str() + 2, nullptr, 10);
+            buffer.erase(0, newline + 1);
+
+            if (type == 'E') return (int) number;
+
+            if (!fill((size_t) number)) return -1;
+            buffer.erase(0, number);
+        }
+    }
+};
+
+/**
+ * @brief Writes a number with a fixed number of decimal places, padded on the left up to the specified width.
+ * @param number the number
+ * @param precision the number of decimal places
+ * @param width the minimum width
+ */
+static void writeFixed(double number, int precision, int width) {
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number, std::chars_format::fixed, precision);
+
+    std::string_view number_(digits, result.ptr - digits);
+    IO::out << std::string((size_t) std::max(0, width - (int) number_.size()), ' ') << number_;
+}
+
+/**
+ * @brief A load test for the server mode of the generated programs (--serve <socket>). Each connection sends the
+ * same command as soon as the reply to the previous one arrives, and the throughput and latency of the requests are
+ * reported at the end.
+ *
+ * Usage: helpy_load_test <socket> [-c <connections>] [-n <requests per connection>] <command>...
+ */
+int main(int argc, char *argv[]) {
+    const char *path = nullptr;
+    unsigned numConnections = 4, numRequests = 10000;
+    std::string line;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-c") && i + 1 < argc)
+            numConnections = std::max(1ul, strtoul(argv[++i], nullptr, 10));
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            numRequests = std::max(1ul, strtoul(argv[++i], nullptr, 10));
+        else if (!path)
+            path = argv[i];
+        else
+            (line += line.empty() ? "" : " ") += argv[i];
+    }
+
+    if (!path || line.empty()) {
+        IO::err << "Usage: " << argv[0] << " <socket> [-c <connections>] [-n <requests per connection>] <command>...\n";
+        return EXIT_FAILURE;
+    }
+
+    line += '\n';
+
+    std::vector<std::unique_ptr<HelpyRuntime::LatencyHistogram>> histograms;
+    std::vector<std::thread> threads;
+    std::atomic<uint64_t> failures = 0, disconnections = 0;
+
+    for (unsigned i = 0; i < numConnections; ++i)
+        histograms.push_back(std::make_unique<HelpyRuntime::LatencyHistogram>());
+
+    auto start = Clock::now();
+
+    for (unsigned i = 0; i < numConnections; ++i) {
+        threads.emplace_back([&, i] {
+            Connection connection(path);
+
+            if (!connection.connected()) {
+                ++disconnections;
+                return;
+            }
+
+            for (unsigned j = 0; j < numRequests; ++j) {
+                auto begin = Clock::now();
+                int status = connection.request(line);
+
+                if (status < 0) {
+                    ++disconnections;
+                    return;
+                }
+
+                histograms[i]->record(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count());
+                if (status) ++failures;
+            }
+        });
+    }
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    HelpyRuntime::LatencyHistogram total;
+    for (const auto &histogram : histograms) total.add(*histogram);
+
+    IO::out << total.count() << " requests over " << numConnections << " connections in ";
+    writeFixed(seconds, 3, 0);
+    IO::out << " s (";
+    writeFixed((double) total.count() / seconds, 0, 0);
+    IO::out << " requests/s), " << failures.load() << " failed";
+
+    if (disconnections) IO::out << ", " << disconnections.load() << " connections lost";
+    IO::out << "\n\nLatency (us)\n";
+
+    std::pair<const char *, double> rows[] = {
+        {"min", (double) total.min()}, {"mean", total.mean()}, {"p50", (double) total.percentile(50)},
+        {"p90", (double) total.percentile(90)}, {"p99", (double) total.percentile(99)},
+        {"p99.9", (double) total.percentile(99.9)}, {"max", (double) total.max()}
+    };
+
+    for (const auto &[name, nanoseconds] : rows) {
+        IO::out << name << std::string(8 - strlen(name), ' ');
+        writeFixed(nanoseconds / 1e3, 3, 12);
+        IO::out << '\n';
+    }
+
+    return (failures || disconnections) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
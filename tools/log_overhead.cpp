@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "io/io.h"
+#include "log/log.h"
+
+namespace IO = HelpyRuntime::IO;
+using Clock = std::chrono::steady_clock;
+using Logger = HelpyRuntime::Utils::Logger;
+
+// the number of messages logged by each thread between flushes, which fit in the ring buffer
+#define BURST_SIZE 256
+
+/**
+ * @brief Measures the time a function takes per call, by calling it repeatedly from several threads at once.
+ * @param numThreads the number of threads
+ * @param numCalls the number of calls per thread
+ * @param function the function, which is called with the index of the call
+ * @param flush boolean indicating if the log is flushed between bursts of calls, which are not timed
+ * @return the time per call, in nanoseconds
+ */
+template <typename F>
+static double measure(unsigned numThreads, size_t numCalls, F function, bool flush) {
+    std::vector<double> nanoseconds(numThreads);
+    std::vector<std::thread> threads;
+
+    for (unsigned i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&, i] {
+            for (size_t call = 0; call < numCalls; ) {
+                size_t end = std::min(numCalls, call + BURST_SIZE / numThreads);
+                auto start = Clock::now();
+
+                for (; call < end; ++call)
+                    function(call);
+
+                nanoseconds[i] += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+                if (flush) Logger::flush();
+            }
+        });
+    }
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    double total = 0;
+    for (double nanoseconds_ : nanoseconds) total += nanoseconds_;
+
+    return total / (double) (numCalls * numThreads);
+}
+
+/**
+ * @brief Writes the overhead of a kind of log call to the standard output.
+ * @param name the kind of call
+ * @param nanoseconds the time per call, in nanoseconds
+ */
+static void report(const char *name, double nanoseconds) {
+    char text[128];
+    snprintf(text, sizeof(text), "%-40s %8.1f ns\n", name, nanoseconds);
+
+    IO::out << text;
+}
+
+/**
+ * @brief Measures the overhead of logging a message with the asynchronous logger (see log/log.h), i.e. the time the
+ * thread that logs it spends, when the level of the message is removed at compile time, when logging is disabled and
+ * when the message is enqueued. Formatting the message in place is measured for comparison.
+ *
+ * Usage: helpy_log_overhead [-n <messages per thread>] [-t <threads>]
+ */
+int main(int argc, char *argv[]) {
+    size_t numMessages = 100000;
+    unsigned numThreads = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)
+            numMessages = std::max(1ul, strtoul(argv[++i], nullptr, 10));
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            numThreads = std::clamp(strtoul(argv[++i], nullptr, 10), 1ul, (unsigned long) BURST_SIZE);
+        else {
+            IO::err << "Usage: " << argv[0] << " [-n <messages per thread>] [-t <threads>]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::string path = (std::filesystem::temp_directory_path() / "helpy_log_overhead.log").string();
+    std::string name = "sorting";
+
+    report("removed at compile time (DEBUG)", measure(numThreads, numMessages, [&name](size_t i) {
+        HELPY_LOG(DEBUG, "{} took {} ms with {} items", name, 1.5, i);
+    }, false));
+
+    report("disabled (logger not started)", measure(numThreads, numMessages, [&name](size_t i) {
+        HELPY_LOG(INFO, "{} took {} ms with {} items", name, 1.5, i);
+    }, false));
+
+    if (!Logger::start(path.c_str())) {
+        IO::err << "Could not open the log '" << path << "'!\n";
+        return EXIT_FAILURE;
+    }
+
+    report("enqueued", measure(numThreads, numMessages, [&name](size_t i) {
+        HELPY_LOG(INFO, "{} took {} ms with {} items", name, 1.5, i);
+    }, true));
+
+    Logger::stop();
+
+    report("formatted in place (snprintf)", measure(numThreads, numMessages, [&name](size_t i) {
+        char text[128];
+        snprintf(text, sizeof(text), "%s took %g ms with %zu items", name.c_str(), 1.5, i);
+
+        asm volatile("" : : "r"(text) : "memory");
+    }, false));
+
+    if (Logger::dropped())
+        IO::out << Logger::dropped() << " messages were dropped\n";
+
+    // the log and its rotated files are only needed for the measurements
+    for (int i = 0; i <= 3; ++i)
+        std::filesystem::remove(i ? path + '.' + std::to_string(i) : path);
+
+    return EXIT_SUCCESS;
+}